@@ -0,0 +1,171 @@
+#include "RobotFitnessEvaluator.hpp"
+#include "RobotProblemConfig.hpp"
+#include "base_solution.hpp"
+#include "net_archive.hpp"
+#include "nop.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace po = boost::program_options;
+
+
+/**
+ * @brief Упаковать набор сетей (best_net.bin и т.п.) в один архив
+ */
+int pack_networks(const std::string& archive_path, const std::vector<std::string>& inputs) {
+    NetArchiveWriter writer;
+    if (!writer.open(archive_path)) {
+        return 1;
+    }
+
+    NetOper net;
+    size_t skipped = 0;
+    for (const auto& path : inputs) {
+        if (!net.loadFromBinaryFile(path)) {
+            std::cerr << "WARNING: Skipping " << path << std::endl;
+            ++skipped;
+            continue;
+        }
+        if (!writer.add(net)) {
+            std::cerr << "WARNING: Could not add " << path << " to the archive, skipping" << std::endl;
+            ++skipped;
+        }
+    }
+
+    const size_t count = writer.size();
+    if (!writer.close()) {
+        return 1;
+    }
+    std::cout << "Packed " << count << " networks into " << archive_path;
+    if (skipped > 0) {
+        std::cout << " (" << skipped << " skipped)";
+    }
+    std::cout << std::endl;
+    return 0;
+}
+
+
+/**
+ * @brief Оценить все сети архива на наборе стартовых состояний
+ * 
+ * Сети декодируются прямо из отображённого файла, потоки разбирают
+ * индексы через общий атомарный счётчик
+ */
+int evaluate_networks(const std::string& archive_path, const std::string& output_path,
+                      const RobotProblemConfig& robot_config, int num_threads) {
+    NetArchive archive;
+    if (!archive.open(archive_path)) {
+        return 1;
+    }
+
+    const size_t count = archive.size();
+    std::cout << "Evaluating " << count << " networks from " << archive_path
+              << " with " << num_threads << " threads" << std::endl;
+
+    RobotFitnessEvaluator evaluator(robot_config, 4);
+    std::vector<std::vector<float>> results(count);
+    std::vector<char> valid(count, 0);
+    std::atomic<size_t> next_index{0};
+
+    auto worker = [&]() {
+        BaseSolution<RobotProblemConfig> solution(robot_config);
+        for (size_t i = next_index++; i < count; i = next_index++) {
+            if (!archive.get(i, solution.getNetOper())) {
+                continue;
+            }
+            results[i] = evaluator.evaluate(solution);
+            valid[i] = 1;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::ofstream out(output_path);
+    if (!out.is_open()) {
+        std::cerr << "ERROR: Could not open " << output_path << std::endl;
+        return 1;
+    }
+
+    out << "Index,Time,Error,Path,Total" << std::endl;
+    size_t best_idx = count;
+    for (size_t i = 0; i < count; ++i) {
+        if (!valid[i]) {
+            continue;
+        }
+        out << i;
+        for (float f : results[i]) {
+            out << "," << f;
+        }
+        out << std::endl;
+
+        if (best_idx == count || results[i].back() < results[best_idx].back()) {
+            best_idx = i;
+        }
+    }
+
+    std::cout << "Results saved to " << output_path << std::endl;
+    if (best_idx < count) {
+        std::cout << "Best network: " << best_idx << " (total " << results[best_idx].back() << ")" << std::endl;
+    }
+    return 0;
+}
+
+
+int main(int argc, char** argv) {
+    po::options_description desc("Evaluate a network archive on a trajectory set");
+    desc.add_options()
+        ("help,h", "show help")
+        ("archive,a", po::value<std::string>()->default_value("networks.nar"), "network archive (*.nar)")
+        ("output,o", po::value<std::string>()->default_value("archive_fitness.csv"), "output CSV")
+        ("threads,j", po::value<int>()->default_value(static_cast<int>(std::thread::hardware_concurrency())),
+            "number of worker threads")
+        ("trajectories,t", po::value<std::string>(), "CSV with start states (Trajectory,Time,X,Y,Theta)")
+        ("model,m", po::value<std::string>(), "ONNX model path")
+        ("pack", po::value<std::vector<std::string>>()->multitoken(),
+            "pack binary networks (*.bin) into --archive instead of evaluating");
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const std::string archive_path = vm["archive"].as<std::string>();
+
+    if (vm.count("pack")) {
+        return pack_networks(archive_path, vm["pack"].as<std::vector<std::string>>());
+    }
+
+    RobotProblemConfig robot_config;
+    robot_config.num_trajectories = 16;
+    if (vm.count("model")) {
+        robot_config.model_path = vm["model"].as<std::string>();
+    }
+    if (vm.count("trajectories")) {
+        robot_config.loadTrajectories(vm["trajectories"].as<std::string>());
+    }
+
+    const int num_threads = std::max(1, vm["threads"].as<int>());
+    return evaluate_networks(archive_path, vm["output"].as<std::string>(), robot_config, num_threads);
+}
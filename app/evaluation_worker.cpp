@@ -0,0 +1,63 @@
+#include "RobotFitnessEvaluator.hpp"
+#include "RobotProblemConfig.hpp"
+#include "remote_evaluator.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace po = boost::program_options;
+
+
+int main(int argc, char** argv) {
+    po::options_description desc("Fitness evaluation worker for a distributed GA run");
+    desc.add_options()
+        ("help,h", "show help")
+        ("connect,c", po::value<std::string>()->default_value("unix:/tmp/nop_evaluator.sock"),
+            "master endpoint (unix:/path or tcp:host:port)")
+        ("model,m", po::value<std::string>(), "ONNX model path")
+        ("trajectories,t", po::value<std::string>(), "CSV with start states (Trajectory,Time,X,Y,Theta)")
+        ("retry", po::value<int>()->default_value(60), "seconds to keep trying to connect");
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    // Конфигурация должна совпадать с master (проверяется по хэшу при подключении)
+    RobotProblemConfig robot_config;
+    robot_config.num_trajectories = 16;
+    if (vm.count("model")) {
+        robot_config.model_path = vm["model"].as<std::string>();
+    }
+    if (vm.count("trajectories")) {
+        robot_config.loadTrajectories(vm["trajectories"].as<std::string>());
+    }
+
+    RobotFitnessEvaluator evaluator(robot_config, 4);
+    const std::string endpoint = vm["connect"].as<std::string>();
+
+    // Master может ещё не слушать - повторяем подключение раз в секунду
+    for (int attempt = 0; attempt <= vm["retry"].as<int>(); ++attempt) {
+        long evaluated = runEvaluationWorker(endpoint, evaluator);
+        if (evaluated >= 0) {
+            std::cout << "Master closed the connection, " << evaluated << " networks evaluated" << std::endl;
+            return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    std::cerr << "ERROR: Could not reach master at " << endpoint << std::endl;
+    return 1;
+}
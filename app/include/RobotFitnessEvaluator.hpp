@@ -11,14 +11,21 @@
 #include "controller.hpp"
 #include "runner.hpp"
 #include "model.hpp"
+#include "config_hash.hpp"
+#include <algorithm>
+#include <atomic>
 #include <vector>
 #include <cmath>
+#include <memory>
+#include <mutex>
 
 
 class RobotFitnessEvaluator : public BaseFitnessEvaluator {
 public:
     explicit RobotFitnessEvaluator(const RobotProblemConfig& config, int num_objectives = 4)
-        : BaseFitnessEvaluator(num_objectives), config_(config) {}
+        : BaseFitnessEvaluator(num_objectives), 
+          config_(config),
+          init_states_(config.generateTrainTrajectories()) {}
     
     
     /**
@@ -30,15 +37,17 @@ public:
             // Используем интерфейс ISolution напрямую - никакого dynamic_cast!
             const NetOper& net = solution.getNetOperConst();
             
-            Model::State currState = {0.0f, 0.0f, 0.0f};
-            Model model(currState, config_.dt, config_.model_path);
-            Model::State goal = {0.0f, 0.0f, 0.0f};
+            // Контекст симуляции берётся из пула: модель уже загружена,
+            // в контроллер копируется сеть и компилируется в оптимизированную программу
+            // (повтор той же сети в этом контексте не перекомпилируется)
+            ContextLease lease(*this, net);
+            SimulationContext& ctx = lease.context();
+            ctx.controller.setNetOper(net);
             
-            Controller controller(goal, const_cast<NetOper&>(net));
-            Runner runner(model, controller);
-            runner.setGoal(goal);
-            
-            std::vector<Model::State> init_states = config_.generateTrainTrajectories();
+            Runner& runner = ctx.runner;
+            DivergenceMonitor monitor(config_.divergence);
+            RolloutCost cost;
+            const Model::State& goal = ctx.goal;
             
             float total_time = 0.0f;
             float total_error = 0.0f;
@@ -46,32 +55,24 @@ public:
             float total_smoothness = 0.0f;
             int successes = 0;
             
-            for (const auto& init_state : init_states) {
+            for (const auto& init_state : init_states_) {
                 runner.init(init_state);
-                float curr_time = 0.0f;
-                float path_length = 0.0f;
-                
-                Model::State prev_state = init_state;
-                Model::State prev_vel = {0, 0, 0};
+                monitor.reset();
+                cost.reset(init_state);
                 
-                while (curr_time < config_.time_limit) {
-                    currState = runner.makeStep();
+                while (cost.time < config_.time_limit) {
+                    const Model::State currState = runner.makeStep();
                     
-                    // Расстояние и путь
-                    float dx = currState.x - prev_state.x;
-                    float dy = currState.y - prev_state.y;
-                    path_length += std::sqrt(dx * dx + dy * dy);
-                    
-                    // Гладкость (штраф за ускорение)
-                    float vx = dx / config_.dt;
-                    float vy = dy / config_.dt;
-                    float ax = (vx - prev_vel.x) / config_.dt;
-                    float ay = (vy - prev_vel.y) / config_.dt;
-                    total_smoothness += std::sqrt(ax*ax + ay*ay) * 0.1f;
+                    // Расходящаяся траектория засчитывается как полная неудачная:
+                    // time_limit, ошибка последнего конечного состояния, штрафные путь и гладкость
+                    if (monitor.diverged(currState, ctx.controller.rawControl())) {
+                        cost.chargeCut(config_.divergence, config_.time_limit);
+                        cut_short_.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    }
                     
-                    prev_state = currState;
-                    prev_vel = {vx, vy, 0};
-                    curr_time += config_.dt;
+                    // Путь и гладкость (штраф за ускорение)
+                    cost.addStep(currState, runner.lastStepDt());
                     
                     if (currState.dist(goal) < config_.epsilon_term) {
                         successes++;
@@ -79,9 +80,12 @@ public:
                     }
                 }
                 
-                total_time += curr_time;
-                total_error += currState.dist(goal);
-                total_path += path_length;
+                // Последний шаг может перейти time_limit; неудача стоит ровно time_limit,
+                // как и прерванная траектория
+                total_time += std::min(cost.time, config_.time_limit);
+                total_error += cost.last.dist(goal);
+                total_path += cost.path;
+                total_smoothness += cost.smoothness;
             }
             
             // Штраф за неудачи
@@ -100,7 +104,118 @@ public:
         }
     }
     
+    /// Сколько траекторий прервано DivergenceMonitor с момента создания
+    size_t cutShortRollouts() const {
+        return cut_short_.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Хэш параметров симуляции и стартовых состояний
+     */
+    uint64_t getConfigHash() const override {
+        ConfigHash hash;
+        hash.add(num_objectives_)
+            .add(config_.dt)
+            .add(config_.time_limit)
+            .add(config_.epsilon_term)
+            .add(config_.integration_method)
+            .add(config_.hold_control)
+            .add(config_.adaptive_stepping.enabled)
+            .add(config_.adaptive_stepping.max_step_multiple)
+            .add(config_.adaptive_stepping.control_tolerance)
+            .add(config_.adaptive_stepping.max_turn)
+            .add(config_.adaptive_stepping.slow_radius)
+            .add(config_.divergence.enabled)
+            .add(config_.divergence.saturation_level)
+            .add(config_.divergence.saturation_steps)
+            .add(config_.divergence.cut_path)
+            .add(config_.divergence.cut_smoothness)
+            .add(config_.num_trajectories)
+            .add(config_.model_path);
+        for (const auto& state : init_states_) {
+            hash.add(state.x).add(state.y).add(state.yaw);
+        }
+        return hash.value();
+    }
+    
     
 private:
+    /**
+     * @brief Долгоживущий контекст симуляции
+     * 
+     * Держит загруженную ONNX модель, контроллер и runner.
+     * Между вызовами evaluate() сбрасывается через Runner::init(),
+     * а не создаётся заново
+     */
+    struct SimulationContext {
+        SimulationContext(const RobotProblemConfig& config, const NetOper& net)
+            : goal{0.0f, 0.0f, 0.0f},
+              model(goal, config.dt, config.model_path),
+              controller(goal, const_cast<NetOper&>(net)),
+              runner(model, controller) {
+            runner.setGoal(goal);
+            runner.setIntegrator(makeIntegrator(config.integration_method, config.hold_control));
+            runner.setAdaptiveStepping(config.adaptive_stepping);
+        }
+        
+        Model::State goal;
+        Model model;
+        Controller controller;
+        Runner runner;
+    };
+    
+    
+    /**
+     * @brief RAII-аренда контекста из пула
+     * 
+     * Каждый одновременный вызов evaluate() (по одному на поток)
+     * получает свой контекст, по завершении контекст возвращается в пул
+     */
+    class ContextLease {
+    public:
+        ContextLease(RobotFitnessEvaluator& owner, const NetOper& net)
+            : owner_(owner), ctx_(owner.acquireContext(net)) {}
+        
+        ~ContextLease() { owner_.releaseContext(std::move(ctx_)); }
+        
+        ContextLease(const ContextLease&) = delete;
+        ContextLease& operator=(const ContextLease&) = delete;
+        
+        SimulationContext& context() { return *ctx_; }
+        
+    private:
+        RobotFitnessEvaluator& owner_;
+        std::unique_ptr<SimulationContext> ctx_;
+    };
+    
+    
+    std::unique_ptr<SimulationContext> acquireContext(const NetOper& net) {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            if (!free_contexts_.empty()) {
+                auto ctx = std::move(free_contexts_.back());
+                free_contexts_.pop_back();
+                return ctx;
+            }
+        }
+        // Пул пуст - первый вызов в этом потоке, загружаем модель один раз
+        return std::make_unique<SimulationContext>(config_, net);
+    }
+    
+    void releaseContext(std::unique_ptr<SimulationContext> ctx) {
+        if (!ctx) return;
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        free_contexts_.push_back(std::move(ctx));
+    }
+    
+    
     RobotProblemConfig config_;
+    
+    /// Стартовые состояния генерируются один раз и только читаются
+    const std::vector<Model::State> init_states_;
+    
+    std::mutex pool_mutex_;
+    std::vector<std::unique_ptr<SimulationContext>> free_contexts_;
+    
+    std::atomic<size_t> cut_short_{0};
 };
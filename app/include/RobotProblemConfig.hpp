@@ -13,6 +13,8 @@
 #include <algorithm>
 #include "base_config.hpp"
 #include "model.hpp"
+#include "integrator.hpp"
+#include "runner.hpp"
 
 struct RobotProblemConfig : public BaseConfig {
     // ===== СПЕЦИФИЧНЫЕ ПАРАМЕТРЫ ДЛЯ РОБОТА =====
@@ -26,6 +28,18 @@ struct RobotProblemConfig : public BaseConfig {
     /// Условие остановки
     float epsilon_term = 0.1f;
     
+    /// Схема интегрирования (Heun/RK4/Arc позволяют увеличить dt)
+    IntegrationMethod integration_method = IntegrationMethod::Euler;
+    
+    /// Держать управление постоянным в пределах шага (один вызов контроллера и NN на шаг)
+    bool hold_control = true;
+    
+    /// Адаптивный шаг (кратный dt), по умолчанию выключен
+    AdaptiveStepping adaptive_stepping;
+    
+    /// Досрочное прерывание траекторий с NaN/inf или насыщенным выходом сети
+    DivergenceGuard divergence;
+    
     /// Количество траекторий для обучения
     int num_trajectories = 8;
     
@@ -41,6 +55,9 @@ struct RobotProblemConfig : public BaseConfig {
     /// Количество стартовых точек для сохранения результатов
     int num_test_trajectories = 16;
     
+    /// Дополнительно экспортировать trajectories.bin в trajectories.csv
+    bool export_trajectories_csv = false;
+    
     /// Кастомные загруженные траектории (опционально)
     std::vector<Model::State> custom_train_trajectories;
     
@@ -1,10 +1,16 @@
 #include "GANOP.hpp"
+#include "cpu_dispatch.hpp"
+#include "fingerprint_evaluator.hpp"
+#include "fixed_point.hpp"
+#include "island_model.hpp"
+#include "remote_evaluator.hpp"
 #include "RobotFitnessEvaluator.hpp"
 #include "base_solution.hpp"
 #include "RobotProblemConfig.hpp"
 #include "controller.hpp"
 #include "runner.hpp"
 #include "model.hpp"       
+#include "trajectory_writer.hpp"
 #include <iostream>
 #include <fstream>
 
@@ -34,6 +40,43 @@ bool file_exists(const std::string& filename) {
  * @brief Сохранить лучшее решение в файлы
  * Сохраняет матрицу и параметры для последующей загрузки
  */
+/**
+ * @brief Точность сети в фиксированной точке Q19.12 на области стартовых состояний
+ *
+ * Входы контроллера - goal - state по сетке внутри [qyminc, qymaxc]
+ */
+void report_fixed_point_accuracy(NetOper& net) {
+    using FixedRobotNet = FixedNetOper<24, 3, 8, 2, Fixed<12>>;
+    
+    std::vector<std::array<float, 3>> inputs;
+    const int steps = 10;
+    for (int i = 0; i <= steps; ++i) {
+        for (int j = 0; j <= steps; ++j) {
+            for (int k = 0; k <= steps; ++k) {
+                std::array<float, 3> x;
+                const int index[3] = {i, j, k};
+                for (int d = 0; d < 3; ++d) {
+                    const float lo = g_robot_config.qyminc[d];
+                    const float hi = g_robot_config.qymaxc[d];
+                    x[d] = -(lo + (hi - lo) * index[d] / steps);
+                }
+                inputs.push_back(x);
+            }
+        }
+    }
+    
+    try {
+        const FixedRobotNet fixed(net);
+        const FixedPointAccuracy report = fixedPointAccuracy(net, fixed, inputs);
+        std::cout << "Fixed-point Q19.12 over start region: max error " << report.max_abs_error
+                  << ", mean error " << report.mean_abs_error
+                  << ", saturated outputs " << report.saturated << "/" << (report.samples + report.saturated)
+                  << ", max |u| " << report.max_output << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "WARNING: Fixed-point accuracy report skipped: " << e.what() << std::endl;
+    }
+}
+
 void save_best_solution(const ISolution& solution) {
     const NetOper& net = solution.getNetOperConst();
     
@@ -51,16 +94,19 @@ void save_best_solution(const ISolution& solution) {
     if (!net_nonconst.saveParametersToFile("best_params.txt")) {
         std::cerr << "WARNING: Failed to save best_params.txt" << std::endl;
     }
+    
+    // Полная сеть (матрица, параметры, узлы) в бинарном виде
+    if (!net_nonconst.saveToBinaryFile("best_net.bin")) {
+        std::cerr << "WARNING: Failed to save best_net.bin" << std::endl;
+    }
 
     // Симулируем траектории и сохраняем
-    std::ofstream outFile("trajectories.csv");
-    if (!outFile.is_open()) {
-        std::cerr << "Failed to open trajectories.csv for writing!" << std::endl;
+    TrajectoryWriter writer;
+    if (!writer.open("trajectories.bin")) {
+        std::cerr << "Failed to open trajectories.bin for writing!" << std::endl;
         return;
     }
     
-    outFile << "Trajectory,Time,X,Y,Theta\n";
-    
     Model::State currState = {0.0f, 0.0f, 0.0f};
     Model model(currState, g_robot_config.dt, g_robot_config.model_path);
     Model::State goal = {0.0f, 0.0f, 0.0f};
@@ -68,6 +114,8 @@ void save_best_solution(const ISolution& solution) {
     Controller controller(goal, net_nonconst);
     Runner runner(model, controller);
     runner.setGoal(goal);
+    runner.setIntegrator(makeIntegrator(g_robot_config.integration_method, g_robot_config.hold_control));
+    runner.setAdaptiveStepping(g_robot_config.adaptive_stepping);
     
     std::vector<Model::State> test_states = g_robot_config.generateTestTrajectories();
     
@@ -76,24 +124,35 @@ void save_best_solution(const ISolution& solution) {
     // Симулируем каждую траекторию
     for (size_t i = 0; i < test_states.size(); ++i) {
         runner.init(test_states[i]);
+        writer.beginTrajectory();
         float currTime = 0.0f;
         
         while (currTime < g_robot_config.time_limit) {
             currState = runner.makeStep();
-            outFile << i << "," << currTime << ","
-                   << currState.x << "," << currState.y << ","
-                   << currState.yaw << "\n";
+            writer.addSample(currTime, currState);
             
-            currTime += g_robot_config.dt;
+            currTime += runner.lastStepDt();
             
             if (currState.dist(goal) < g_robot_config.epsilon_term) {
                 break;
             }
         }
+        writer.endTrajectory();
     }
     
-    outFile.close();
-    std::cout << "Trajectories logged to trajectories.csv (" << test_states.size() << " trajectories)" << std::endl;
+    if (!writer.close()) {
+        std::cerr << "WARNING: Failed to save trajectories.bin" << std::endl;
+    } else {
+        std::cout << "Trajectories logged to trajectories.bin (" << test_states.size() << " trajectories)" << std::endl;
+        
+        if (g_robot_config.export_trajectories_csv) {
+            if (exportTrajectoriesToCsv("trajectories.bin", "trajectories.csv")) {
+                std::cout << "Trajectories exported to trajectories.csv" << std::endl;
+            } else {
+                std::cerr << "WARNING: Failed to export trajectories.csv" << std::endl;
+            }
+        }
+    }
     
     // Вывод параметров сети
     std::cout << "Parameters: ";
@@ -101,6 +160,8 @@ void save_best_solution(const ISolution& solution) {
         std::cout << p << " ";
     }
     std::cout << std::endl;
+    
+    report_fixed_point_accuracy(net_nonconst);
 }
 
 
@@ -110,9 +171,15 @@ int main() {
     robot_config.dt = 0.033333f;
     robot_config.time_limit = 15.0f;
     robot_config.epsilon_term = 0.1f;
+    robot_config.integration_method = IntegrationMethod::Euler;
+    robot_config.hold_control = true;
+    robot_config.adaptive_stepping.enabled = false;
+    robot_config.divergence.enabled = true;     // прерывать траектории с NaN/inf и насыщенной сетью
+    robot_config.divergence.saturation_steps = 60;
     
     robot_config.num_trajectories = 16;
     robot_config.num_test_trajectories = 64;  
+    robot_config.export_trajectories_csv = false;
     
     robot_config.qyminc = {-5.5f, -5.5f, -1.31f};
     robot_config.qymaxc = {5.5f, 5.5f, 1.31f};
@@ -132,11 +199,25 @@ int main() {
     ga_config.mutation_prob = 1.0f;
     ga_config.selection_alpha = 0.9f;
     ga_config.search_neighbors = 256;
+    ga_config.effective_mutations = true;  // не тратить симуляцию на потомка с той же матрицей
     ga_config.int_bits = 16;
     ga_config.frac_bits = 16;
     ga_config.num_params = 8;
     ga_config.num_struct_variations = 20;
     ga_config.seed = 69;
+    ga_config.pareto_archive_path = "pareto_front.nar";
+    ga_config.elite_archive_path = "elite_archive.nar";
+    ga_config.asynchronous = false;        // true - steady-state на пуле потоков
+    ga_config.async_workers = 0;           // 0 - по числу ядер
+    ga_config.checkpoint_path = "ganop_checkpoint.bin";
+    ga_config.checkpoint_interval = 1;
+    
+    // Островная модель: >1 - несколько популяций в своих потоках с миграцией
+    IslandConfig island_config;
+    island_config.num_islands = 1;
+    island_config.migration_interval = 3;
+    island_config.migrants_per_island = 4;
+    island_config.topology = MigrationTopology::Ring;
     
     // Инициализируем шаблон один раз
     ga_config.nop_template = std::make_shared<NetOper>();
@@ -150,7 +231,16 @@ int main() {
     bool loaded_from_file = false;
     
     // Проверяем существуют ли файлы сохранённого состояния (без C++17)
-    if (file_exists("best_matrix.txt") && file_exists("best_params.txt")) {
+    if (file_exists("best_net.bin")) {
+        std::cout << "Found saved binary network best_net.bin" << std::endl;
+        
+        if (ga_config.nop_template->loadFromBinaryFile("best_net.bin")) {
+            std::cout << "✓ Successfully loaded network from best_net.bin" << std::endl;
+            loaded_from_file = true;
+        } else {
+            std::cerr << "WARNING: Failed to load best_net.bin, using base configuration" << std::endl;
+        }
+    } else if (file_exists("best_matrix.txt") && file_exists("best_params.txt")) {
         std::cout << "Found saved network state files!" << std::endl;
         
         if (ga_config.nop_template->loadMatrixFromFile("best_matrix.txt") &&
@@ -173,13 +263,43 @@ int main() {
     }
     
     std::cout << "NetOper template initialized" << std::endl;
+    std::cout << "Vector kernels: " << cpuIsaName(activeCpuIsa()) << " (override with NOP_ISA)" << std::endl;
+    
+    // Начальная популяция дополняется Парето-фронтом прошлого запуска
+    if (file_exists(ga_config.pareto_archive_path)) {
+        std::cout << "Found saved Pareto front " << ga_config.pareto_archive_path << std::endl;
+        ga_config.warm_start_archive = ga_config.pareto_archive_path;
+    }
 
     // Сохраняем конфиги глобально для доступа в колбэках
     g_robot_config = robot_config;
     g_ga_config = ga_config;
     
     // === 3. Инъекция зависимостей ===
-    ga_config.fitness_evaluator = std::make_shared<RobotFitnessEvaluator>(robot_config, 4);
+    auto robot_evaluator = std::make_shared<RobotFitnessEvaluator>(robot_config, 4);
+    ga_config.fitness_evaluator = robot_evaluator;
+    
+    // Распределённая оценка: сети отправляются процессам evaluation_worker
+    bool use_remote_workers = false;
+    RemoteEvaluatorConfig remote_config;
+    remote_config.endpoint = "unix:/tmp/nop_evaluator.sock";  // или "tcp::5555" для других машин
+    remote_config.batch_size = 4;
+    remote_config.timeout_ms = 120000;
+    if (use_remote_workers) {
+        ga_config.fitness_evaluator = std::make_shared<RemoteFitnessEvaluator>(remote_config, ga_config.fitness_evaluator);
+    }
+    
+    // Сети с одинаковыми выходами на пробных входах не симулируются повторно
+    bool use_fingerprint_cache = false;
+    FingerprintConfig fingerprint_config;
+    fingerprint_config.num_probes = 64;
+    fingerprint_config.probe_range = 3.0f;
+    fingerprint_config.quantum = 1e-4f;
+    std::shared_ptr<FingerprintEvaluator> fingerprint_cache;
+    if (use_fingerprint_cache) {
+        fingerprint_cache = std::make_shared<FingerprintEvaluator>(ga_config.fitness_evaluator, fingerprint_config);
+        ga_config.fitness_evaluator = fingerprint_cache;
+    }
     
     // Factory для создания решений с использованием BaseSolution
     ga_config.solution_factory = [robot_config, &ga_config]() -> std::unique_ptr<ISolution> {
@@ -200,14 +320,32 @@ int main() {
     std::cout << "Test trajectories: " << robot_config.num_test_trajectories << std::endl;
     
     try {
-        GANOP ga(ga_config);
-        ga.run();
+        if (island_config.num_islands > 1) {
+            std::cout << "Islands: " << island_config.num_islands << std::endl;
+            IslandModel model(ga_config, island_config);
+            model.run();
+        } else {
+            GANOP ga(ga_config);
+            ga.run();
+        }
         
         std::cout << "\n=== GA COMPLETED SUCCESSFULLY ===" << std::endl;
+        if (fingerprint_cache) {
+            const FingerprintStats stats = fingerprint_cache->stats();
+            std::cout << "Fingerprint cache: " << stats.hits << " hits, " << stats.misses
+                      << " simulated, " << stats.collisions << " hash collisions" << std::endl;
+        }
+        std::cout << "Diverged trajectories cut short: " << robot_evaluator->cutShortRollouts() << std::endl;
         std::cout << "Results saved to:" << std::endl;
         std::cout << "  - best_matrix.txt" << std::endl;
         std::cout << "  - best_params.txt" << std::endl;
-        std::cout << "  - trajectories.csv" << std::endl;
+        std::cout << "  - best_net.bin" << std::endl;
+        std::cout << "  - " << ga_config.pareto_archive_path << std::endl;
+        std::cout << "  - " << ga_config.elite_archive_path << std::endl;
+        std::cout << "  - trajectories.bin" << std::endl;
+        if (robot_config.export_trajectories_csv) {
+            std::cout << "  - trajectories.csv" << std::endl;
+        }
         std::cout << "  - evolution_log.txt" << std::endl;
         
     } catch (const std::exception& e) {
@@ -1,12 +1,119 @@
 #include "GANOP.hpp"
+#include "config_hash.hpp"
+#include "counter_rng.hpp"
+#include "net_archive.hpp"
+#include "pareto_archive.hpp"
+#include "rank_selection.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
 #include <iostream>
-#include <random>
+#include <iterator>
 #include <stdexcept>
+#include <thread>
+
+
+namespace {
+
+constexpr char CheckpointMagic[8] = {'N', 'O', 'P', 'C', 'K', 'P', 'T', '\0'};
+constexpr uint32_t CheckpointVersion = 3;
+
+/// Сколько раз mutate() перегенерирует вариацию, не меняющую матрицу (effective_mutations)
+constexpr int EffectiveMutationAttempts = 32;
+
+/**
+ * @brief Заголовок чекпоинта GANOP
+ * 
+ * Состояние генератора не хранится: случайные числа поколения g выводятся из (seed, g).
+ * Дальше идут по каждой особи биты параметров (uint8[total_bits]), вариации структуры (uint32 длина + int32[длина]
+ * на каждую), фитнес (float32[num_objectives]) и ранг (int32). В конце - архив элиты:
+ * uint32 число решений, по каждому хромосома в том же виде и фитнес
+ */
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t generation;
+    uint64_t config_hash;
+    uint32_t population_size;
+    uint32_t total_bits;
+    uint32_t num_struct_variations;
+    uint32_t num_objectives;
+    uint32_t reserved;
+    uint32_t checksum;          // FNV-1a всего, что после заголовка
+};
+
+static_assert(sizeof(CheckpointHeader) == 48, "CheckpointHeader must be 48 bytes");
+
+uint32_t checksum32(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename T>
+void appendRaw(std::vector<char>& out, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool readRaw(const char*& it, const char* end, T& value) {
+    if (static_cast<size_t>(end - it) < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, it, sizeof(T));
+    it += sizeof(T);
+    return true;
+}
+
+void appendChromosome(std::vector<char>& out, const std::vector<int>& params,
+                      const std::vector<std::vector<int>>& structure) {
+    for (int bit : params) {
+        appendRaw(out, static_cast<uint8_t>(bit));
+    }
+    for (const auto& variation : structure) {
+        appendRaw(out, static_cast<uint32_t>(variation.size()));
+        for (int w : variation) {
+            appendRaw(out, static_cast<int32_t>(w));
+        }
+    }
+}
+
+bool readChromosome(const char*& it, const char* end, uint32_t total_bits, int num_variations,
+                    std::vector<int>& params, std::vector<std::vector<int>>& structure) {
+    params.resize(total_bits);
+    for (uint32_t j = 0; j < total_bits; ++j) {
+        uint8_t bit = 0;
+        if (!readRaw(it, end, bit)) return false;
+        params[j] = bit;
+    }
+    structure.resize(num_variations);
+    for (auto& variation : structure) {
+        uint32_t length = 0;
+        if (!readRaw(it, end, length) || length > static_cast<uint32_t>(end - it) / sizeof(int32_t)) return false;
+        variation.resize(length);
+        for (uint32_t k = 0; k < length; ++k) {
+            int32_t w = 0;
+            if (!readRaw(it, end, w)) return false;
+            variation[k] = w;
+        }
+    }
+    return true;
+}
+
+}  // namespace
 
 GANOP::GANOP(const GAConfig& config)
-    : config_(config), rng_(config.seed) {
+    : config_(config) {
     
     if (!config.fitness_evaluator) {
         throw std::runtime_error("fitness_evaluator must be provided");
@@ -28,130 +135,350 @@ GANOP::GANOP(const GAConfig& config)
     population_struct_.assign(config.population_size,
                               std::vector<std::vector<int>>(config.num_struct_variations));
     
-    fitness_population_.assign(config.population_size,
-                               std::vector<float>(num_objectives));
+    fitness_population_.resize(config.population_size, num_objectives);
     pareto_ranks_.assign(config.population_size, 0);
+    rank_heap_.assign(pareto_ranks_);
+    elite_archive_.reset(num_objectives);
+    fitness_known_.assign(config.population_size, 0);
 }
 
 void GANOP::run() {
-    std::cout << "Initializing population..." << std::endl;
-    initializePopulation();
+    const int first_generation = initialize();
     
-    std::cout << "Evaluating initial population..." << std::endl;
-    evaluatePopulation();
-    updateParetoRanks();
+    // Главный цикл эволюции
+    if (config_.asynchronous) {
+        runAsynchronous(first_generation);
+    } else {
+        for (int generation = first_generation; generation <= config_.num_generations; ++generation) {
+            runGeneration(generation);
+        }
+    }
     
-    // Вызов колбэка для поколения 0
-    if (config_.on_generation_end) {
-        float sum_fitness = 0.0f;
-        int num_obj = config_.fitness_evaluator->getNumObjectives();
+    finish();
+}
+
+
+int GANOP::initialize() {
+    const bool checkpointing = !config_.checkpoint_path.empty();
+    int first_generation = 1;
+    int checkpoint_generation = 0;
+    
+    if (checkpointing && config_.resume_from_checkpoint &&
+        loadCheckpoint(config_.checkpoint_path, checkpoint_generation)) {
+        std::cout << "Resumed from checkpoint " << config_.checkpoint_path
+                  << " at generation " << checkpoint_generation << std::endl;
+        nop_template_ = *config_.nop_template;
+        first_generation = checkpoint_generation + 1;
+    } else {
+        std::cout << "Initializing population..." << std::endl;
+        initializePopulation();
+        
+        std::cout << "Evaluating initial population..." << std::endl;
+        evaluatePopulation();
+        updateParetoRanks();
         for (int i = 0; i < config_.population_size; ++i) {
-            if (num_obj > 0) {
-                sum_fitness += fitness_population_[i][num_obj - 1];
-            }
+            offerElite(population_params_[i], population_struct_[i], fitness_population_.row(i));
+        }
+        
+        // Вызов колбэка для поколения 0
+        reportGeneration(0);
+        
+        if (checkpointDue(0)) {
+            saveCheckpoint(config_.checkpoint_path, 0);
         }
-        float avg_fitness = config_.population_size > 0 
-            ? sum_fitness / static_cast<float>(config_.population_size) 
-            : 0.0f;
-        config_.on_generation_end(0, avg_fitness);
     }
     
-    // Главный цикл эволюции
-    for (int generation = 1; generation <= config_.num_generations; ++generation) {
-        std::cout << generation << " / " << config_.num_generations << std::endl;
+    return first_generation;
+}
+
+
+void GANOP::runGeneration(int generation) {
+    std::cout << generation << " / " << config_.num_generations << std::endl;
+    
+    int num_obj = config_.fitness_evaluator->getNumObjectives();
+    
+    // В цикле crossover_idx
+    for (int crossover_idx = 0; crossover_idx < config_.num_crossovers_per_gen; ++crossover_idx) {
+        std::vector<std::vector<int>> offspring_params(4);
+        std::vector<std::vector<std::vector<int>>> offspring_struct(4);
+        if (!breedOffspring(generation, crossover_idx, offspring_params, offspring_struct)) {
+            continue;
+        }
+        
+        std::vector<std::vector<float>> offspring_fitness(4);  // ← Кэш фитнесса
+        std::vector<int> offspring_ranks(4);                   // ← Кэш рангов
         
-        // В цикле crossover_idx
-        for (int crossover_idx = 0; crossover_idx < config_.num_crossovers_per_gen; ++crossover_idx) {
-            int parent1, parent2;
-            selectParents(parent1, parent2);
+        // ===== ЭТАП 1: Оценка всех 4 потомков (одним пакетом) =====
+        std::vector<std::unique_ptr<ISolution>> solutions(4);
+        std::vector<const ISolution*> batch(4);
+        for (int offspring = 0; offspring < 4; ++offspring) {
+            solutions[offspring] = config_.solution_factory();
+            solutions[offspring]->decode(offspring_params[offspring], offspring_struct[offspring]);
+            batch[offspring] = solutions[offspring].get();
+        }
+        
+        auto results = config_.fitness_evaluator->evaluateBatch(batch);
+        for (int offspring = 0; offspring < 4; ++offspring) {
+            if (offspring >= static_cast<int>(results.size()) ||
+                results[offspring].size() != static_cast<size_t>(num_obj)) {
+                throw std::runtime_error(
+                    "Fitness function returned wrong number of objectives"
+                );
+            }
+            offspring_fitness[offspring] = results[offspring];
             
-            std::uniform_real_distribution<float> dist_real(0.0f, 1.0f);
-            float ksi = dist_real(rng_);
+            // Вычисляем ранг один раз
+            offspring_ranks[offspring] = computeRank(offspring_fitness[offspring]);
+        }
+        
+        // ===== ЭТАП 2: Замена потомков в популяции =====
+        for (int offspring = 0; offspring < 4; ++offspring) {
+            insertOffspring(offspring_params[offspring], offspring_struct[offspring],
+                            offspring_fitness[offspring], offspring_ranks[offspring],
+                            generation, crossover_idx * 4 + offspring);
+        }
+    }
+
+    // Обновление всех рангов Парето
+    updateParetoRanks();
+    
+    // Вызов колбэка поколения
+    reportGeneration(generation);
+    
+    if (checkpointDue(generation)) {
+        saveCheckpoint(config_.checkpoint_path, generation);
+    }
+}
+
+
+void GANOP::runAsynchronous(int first_generation) {
+    const int num_obj = config_.fitness_evaluator->getNumObjectives();
+    int num_workers = config_.async_workers > 0
+        ? config_.async_workers
+        : static_cast<int>(std::thread::hardware_concurrency());
+    num_workers = std::max(1, num_workers);
+    
+    const long per_generation = std::max(1, config_.num_crossovers_per_gen * 4);
+    const long total = std::max(0, config_.num_generations - first_generation + 1) * per_generation;
+    
+    struct Task {
+        std::vector<int> params;
+        std::vector<std::vector<int>> structure;
+        std::vector<float> fitness;
+        std::exception_ptr error;
+    };
+    
+    std::mutex mutex;
+    std::condition_variable tasks_cv;
+    std::condition_variable results_cv;
+    std::deque<Task> tasks;
+    std::deque<Task> results;
+    bool stop = false;
+    
+    // Потоки только декодируют и оценивают; популяцию меняет лишь этот поток
+    auto worker = [&]() {
+        for (;;) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                tasks_cv.wait(lock, [&]() { return stop || !tasks.empty(); });
+                if (stop) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
             
-            int num_obj = config_.fitness_evaluator->getNumObjectives();
-            float prob1 = (1.0f + config_.selection_alpha * pareto_ranks_[parent1]) / 
-                        (1.0f + pareto_ranks_[parent1]);
-            float prob2 = (1.0f + config_.selection_alpha * pareto_ranks_[parent2]) / 
-                        (1.0f + pareto_ranks_[parent2]);
+            try {
+                auto solution = config_.solution_factory();
+                solution->decode(task.params, task.structure);
+                task.fitness = config_.fitness_evaluator->evaluate(*solution);
+            } catch (...) {
+                task.error = std::current_exception();
+            }
             
-            if (ksi < prob1 || ksi < prob2) {
-                std::vector<std::vector<int>> offspring_params(4);
-                std::vector<std::vector<std::vector<int>>> offspring_struct(4);
-                std::vector<std::vector<float>> offspring_fitness(4);  // ← Кэш фитнесса
-                std::vector<int> offspring_ranks(4);                   // ← Кэш рангов
-                
-                crossover(parent1, parent2, offspring_params, offspring_struct);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                results.push_back(std::move(task));
+            }
+            results_cv.notify_one();
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_workers; ++t) {
+        threads.emplace_back(worker);
+    }
+    
+    auto stop_workers = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        tasks_cv.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+    
+    try {
+        long submitted = 0;
+        long completed = 0;
+        long bred = 0;
+        long in_generation = 0;
+        int generation = first_generation;
+        std::vector<std::vector<int>> offspring_params(4);
+        std::vector<std::vector<std::vector<int>>> offspring_struct(4);
+        std::deque<Task> ready;
+        
+        if (total > 0) {
+            std::cout << generation << " / " << config_.num_generations << std::endl;
+        }
+        
+        while (completed < total) {
+            // Очередь держим заполненной: на каждый поток - по оценке в работе и по одной в запасе
+            while (submitted - completed < 2L * num_workers && submitted < total) {
+                if (!breedOffspring(generation, static_cast<int>(bred++), offspring_params, offspring_struct)) {
+                    continue;
+                }
                 
-                // ===== ЭТАП 1: Оценка всех 4 потомков =====
-                for (int offspring = 0; offspring < 4; ++offspring) {
-                    if (dist_real(rng_) < config_.mutation_prob) {
-                        mutate(offspring_params[offspring], offspring_struct[offspring]);
-                    }
-                    
-                    auto solution = config_.solution_factory();
-                    solution->decode(offspring_params[offspring], offspring_struct[offspring]);
-                    offspring_fitness[offspring] = config_.fitness_evaluator->evaluate(*solution);
-                    
-                    if (offspring_fitness[offspring].size() != static_cast<size_t>(num_obj)) {
-                        throw std::runtime_error(
-                            "Fitness function returned wrong number of objectives"
-                        );
-                    }
-                    
-                    // Вычисляем ранг один раз
-                    offspring_ranks[offspring] = computeRank(offspring_fitness[offspring]);
+                std::lock_guard<std::mutex> lock(mutex);
+                for (int offspring = 0; offspring < 4 && submitted < total; ++offspring, ++submitted) {
+                    Task task;
+                    task.params = offspring_params[offspring];
+                    task.structure = offspring_struct[offspring];
+                    tasks.push_back(std::move(task));
+                }
+            }
+            tasks_cv.notify_all();
+            
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                results_cv.wait(lock, [&]() { return !results.empty(); });
+                ready.swap(results);
+            }
+            
+            // Каждый готовый результат сразу сравнивается с текущей худшей особью
+            for (auto& task : ready) {
+                if (task.error) {
+                    std::rethrow_exception(task.error);
+                }
+                if (task.fitness.size() != static_cast<size_t>(num_obj)) {
+                    throw std::runtime_error(
+                        "Fitness function returned wrong number of objectives"
+                    );
                 }
                 
-                // ===== ЭТАП 2: Замена потомков в популяции =====
-                for (int offspring = 0; offspring < 4; ++offspring) {
-                    // Поиск worst_idx (можно оптимизировать, но так точнее соответствует оригиналу)
-                    int worst_idx = 0;
-                    int max_rank = pareto_ranks_[0];
-                    for (int i = 1; i < config_.population_size; ++i) {
-                        if (pareto_ranks_[i] > max_rank) {
-                            max_rank = pareto_ranks_[i];
-                            worst_idx = i;
-                        }
+                insertOffspring(task.params, task.structure, task.fitness, computeRank(task.fitness),
+                                generation, static_cast<int>(in_generation));
+                ++completed;
+                
+                if (++in_generation == per_generation) {
+                    updateParetoRanks();
+                    reportGeneration(generation);
+                    if (checkpointDue(generation)) {
+                        saveCheckpoint(config_.checkpoint_path, generation);
                     }
-                    
-                    // Замена
-                    if (offspring_ranks[offspring] < max_rank) {
-                        population_params_[worst_idx] = offspring_params[offspring];
-                        population_struct_[worst_idx] = offspring_struct[offspring];
-                        fitness_population_[worst_idx] = offspring_fitness[offspring];
-                        pareto_ranks_[worst_idx] = offspring_ranks[offspring];
-                        
-                        std::uniform_int_distribution<int> dist_idx(0, config_.population_size - 1);
-                        for (int k = 0; k < 10; ++k) {
-                            int random_idx = dist_idx(rng_);
-                            if (random_idx != worst_idx) {
-                                pareto_ranks_[random_idx] = computeRank(fitness_population_[random_idx]);
-                            }
-                        }
+                    in_generation = 0;
+                    if (++generation <= config_.num_generations) {
+                        std::cout << generation << " / " << config_.num_generations << std::endl;
                     }
                 }
             }
+            ready.clear();
         }
+    } catch (...) {
+        stop_workers();
+        throw;
+    }
+    
+    stop_workers();
+}
 
-        // Обновление всех рангов Парето
-        updateParetoRanks();
-        
-        // Вызов колбэка поколения
-        if (config_.on_generation_end) {
-            float sum_fitness = 0.0f;
-            int num_obj = config_.fitness_evaluator->getNumObjectives();
-            for (int i = 0; i < config_.population_size; ++i) {
-                if (num_obj > 0) {
-                    sum_fitness += fitness_population_[i][num_obj - 1];
-                }
-            }
-            float avg_fitness = config_.population_size > 0 
-                ? sum_fitness / static_cast<float>(config_.population_size) 
-                : 0.0f;
-            config_.on_generation_end(generation, avg_fitness);
+
+bool GANOP::breedOffspring(int generation, int index,
+                           std::vector<std::vector<int>>& offspring_params,
+                           std::vector<std::vector<std::vector<int>>>& offspring_struct) {
+    CounterRng selection_rng = makeRng(generation, index, RngPurpose::Selection);
+    int parent1, parent2;
+    selectParents(parent1, parent2, selection_rng);
+    
+    float ksi = selection_rng.uniformReal();
+    
+    float prob1 = (1.0f + config_.selection_alpha * pareto_ranks_[parent1]) / 
+                (1.0f + pareto_ranks_[parent1]);
+    float prob2 = (1.0f + config_.selection_alpha * pareto_ranks_[parent2]) / 
+                (1.0f + pareto_ranks_[parent2]);
+    
+    if (!(ksi < prob1 || ksi < prob2)) {
+        return false;
+    }
+    
+    CounterRng crossover_rng = makeRng(generation, index, RngPurpose::Crossover);
+    crossover(parent1, parent2, offspring_params, offspring_struct, crossover_rng);
+    
+    for (int offspring = 0; offspring < 4; ++offspring) {
+        CounterRng mutation_rng = makeRng(generation, index * 4 + offspring, RngPurpose::Mutation);
+        if (mutation_rng.uniformReal() < config_.mutation_prob) {
+            mutate(offspring_params[offspring], offspring_struct[offspring], mutation_rng);
         }
     }
+    return true;
+}
+
+
+bool GANOP::insertOffspring(const std::vector<int>& params,
+                            const std::vector<std::vector<int>>& structure,
+                            const std::vector<float>& fitness, int rank,
+                            int generation, int index) {
+    // Архив элиты видит каждого оценённого потомка, даже не попавшего в популяцию
+    offerElite(params, structure, fitness);
+    
+    // Худшая особь - вершина кучи рангов (при равных рангах - меньший индекс, как в оригинале)
+    const int worst_idx = rank_heap_.top();
+    const int max_rank = rank_heap_.topRank();
     
+    // Замена
+    if (rank >= max_rank) {
+        return false;
+    }
+    
+    population_params_[worst_idx] = params;
+    population_struct_[worst_idx] = structure;
+    fitness_population_.setRow(worst_idx, fitness);
+    setRank(worst_idx, rank);
+    
+    CounterRng rng = makeRng(generation, index, RngPurpose::Replacement);
+    for (int k = 0; k < 10; ++k) {
+        int random_idx = rng.uniformInt(config_.population_size);
+        if (random_idx != worst_idx) {
+            setRank(random_idx, computeRank(fitness_population_.row(random_idx)));
+        }
+    }
+    return true;
+}
+
+
+void GANOP::reportGeneration(int generation) {
+    if (!config_.on_generation_end) {
+        return;
+    }
+    
+    float sum_fitness = 0.0f;
+    int num_obj = config_.fitness_evaluator->getNumObjectives();
+    for (int i = 0; i < config_.population_size; ++i) {
+        if (num_obj > 0) {
+            sum_fitness += fitness_population_.at(i, num_obj - 1);
+        }
+    }
+    float avg_fitness = config_.population_size > 0 
+        ? sum_fitness / static_cast<float>(config_.population_size) 
+        : 0.0f;
+    config_.on_generation_end(generation, avg_fitness);
+}
+
+
+void GANOP::finish() {
     // Выбор Парето-оптимальных решений
     updateParetoRanks();
     
@@ -160,11 +487,33 @@ void GANOP::run() {
     
     std::cout << "Best Pareto solution found at index: " << best_idx << std::endl;
     std::cout << "Fitness values: ";
-    for (float f : fitness_population_[best_idx]) {
+    for (float f : fitness_population_.row(best_idx)) {
         std::cout << f << " ";
     }
     std::cout << std::endl;
     
+    std::cout << "Structural mutations: " << mutation_stats_.mutations
+              << ", no-op: " << mutation_stats_.noop_variations
+              << ", resampled: " << mutation_stats_.resampled_variations << std::endl;
+    
+    if (!config_.pareto_archive_path.empty()) {
+        if (saveParetoArchive(config_.pareto_archive_path)) {
+            std::cout << "Pareto front (" << pareto_indices_.size() << " networks) saved to "
+                      << config_.pareto_archive_path << std::endl;
+        } else {
+            std::cerr << "WARNING: Failed to save " << config_.pareto_archive_path << std::endl;
+        }
+    }
+    
+    if (!config_.elite_archive_path.empty()) {
+        if (saveEliteArchive(config_.elite_archive_path)) {
+            std::cout << "Elite archive (" << elite_archive_.size() << " networks) saved to "
+                      << config_.elite_archive_path << std::endl;
+        } else {
+            std::cerr << "WARNING: Failed to save " << config_.elite_archive_path << std::endl;
+        }
+    }
+    
     // Вызов финального колбэка
     if (config_.on_algorithm_end) {
         auto best_solution = config_.solution_factory();
@@ -175,8 +524,6 @@ void GANOP::run() {
 
 // src/GANOP.cpp
 void GANOP::initializePopulation() {
-    std::uniform_int_distribution<int> dist_bit(0, 1);
-    
     // auto temp_solution = config_.solution_factory();
     // auto robot_sol = dynamic_cast<RobotSolution*>(temp_solution.get());
     
@@ -213,15 +560,113 @@ void GANOP::initializePopulation() {
     // === Остальная популяция ===
     for (int i = 1; i < config_.population_size; ++i) {
         // Генерируем вариации структуры
+        CounterRng variation_rng = makeRng(0, i, RngPurpose::StructVariation);
         for (int j = 0; j < config_.num_struct_variations; ++j) {
-            nop.GenVar(population_struct_[i][j]);
+            nop.GenVar(population_struct_[i][j], variation_rng);
         }
         
         // Генерируем случайные параметры (как в оригинале)
+        CounterRng params_rng = makeRng(0, i, RngPurpose::Initialization);
         for (int j = 0; j < static_cast<int>(population_params_[i].size()); ++j) {
-            population_params_[i][j] = dist_bit(rng_);
+            population_params_[i][j] = params_rng.uniformInt(2);
+        }
+    }
+    
+    // === Тёплый старт из архива ===
+    std::fill(fitness_known_.begin(), fitness_known_.end(), 0);
+    if (!config_.warm_start_archive.empty()) {
+        int seeded = seedFromArchive(config_.warm_start_archive);
+        std::cout << "Seeded " << seeded << " individuals from " << config_.warm_start_archive << std::endl;
+    }
+}
+
+
+int GANOP::seedFromArchive(const std::string& filepath) {
+    NetArchive archive;
+    if (!archive.open(filepath)) {
+        return 0;
+    }
+    
+    const int num_obj = config_.fitness_evaluator->getNumObjectives();
+    const uint64_t evaluator_hash = config_.fitness_evaluator->getConfigHash();
+    const bool reuse_fitness = evaluator_hash != 0 &&
+                               archive.configHash() == evaluator_hash &&
+                               archive.numObjectives() == static_cast<uint32_t>(num_obj);
+    
+    // Особь 0 остаётся шаблоном, остальные места занимают сети из архива
+    int seeded = 0;
+    int reused = 0;
+    NetOper net;
+    for (size_t k = 0; k < archive.size() && seeded + 1 < config_.population_size; ++k) {
+        if (!archive.get(k, net)) {
+            continue;
+        }
+        
+        const int idx = seeded + 1;
+        const bool exact = encodeNetwork(net, population_params_[idx], population_struct_[idx]);
+        if (exact && reuse_fitness) {
+            const float* fitness = archive.fitness(k);
+            fitness_population_.setRow(idx, fitness);
+            fitness_known_[idx] = 1;
+            ++reused;
+        }
+        ++seeded;
+    }
+    
+    if (reused > 0) {
+        std::cout << "Reused stored fitness for " << reused << " individuals" << std::endl;
+    }
+    return seeded;
+}
+
+
+bool GANOP::encodeNetwork(NetOper& net,
+                          std::vector<int>& chromosome_params,
+                          std::vector<std::vector<int>>& chromosome_struct) {
+    vectorToGrey(chromosome_params, net);
+    chromosome_params.resize(config_.num_params * (config_.int_bits + config_.frac_bits));
+    
+    // Базовая матрица, от которой считаются вариации, - решение без вариаций
+    auto base = config_.solution_factory();
+    base->decode(chromosome_params, {});
+    const std::vector<std::vector<int>> base_matrix = base->getNetOper().getPsi();
+    const std::vector<std::vector<int>>& target = net.getPsi();
+    
+    chromosome_struct.assign(config_.num_struct_variations, std::vector<int>(4, 0));
+    if (base_matrix.size() != target.size()) {
+        return false;
+    }
+    
+    // Разница матриц в виде вариаций (порядок важен: дугу можно добавить
+    // только в узел с ненулевой диагональю, обнуление диагоналей - в конце)
+    const int L = static_cast<int>(target.size());
+    std::vector<std::vector<int>> variations;
+    for (int i = 0; i < L; ++i) {
+        if (base_matrix[i][i] != target[i][i] && base_matrix[i][i] != 0 && target[i][i] != 0) {
+            variations.push_back({1, i, i, target[i][i]});
         }
     }
+    for (int i = 0; i < L; ++i) {
+        for (int j = 0; j < L; ++j) {
+            if (i == j || base_matrix[i][j] == target[i][j]) continue;
+            variations.push_back({base_matrix[i][j] != 0 ? 0 : 2, i, j, target[i][j]});
+        }
+    }
+    for (int i = 0; i < L; ++i) {
+        if (base_matrix[i][i] != 0 && target[i][i] == 0) {
+            variations.push_back({1, i, i, 0});
+        }
+    }
+    
+    // Лишние отличия не помещаются в хромосому - особь будет только приближением
+    const size_t count = std::min(variations.size(), chromosome_struct.size());
+    std::copy(variations.begin(), variations.begin() + count, chromosome_struct.begin());
+    
+    // Точность проверяем декодированием
+    auto decoded = config_.solution_factory();
+    decoded->decode(chromosome_params, chromosome_struct);
+    return decoded->getNetOper().getPsi() == target &&
+           decoded->getParameters() == net.get_parameters();
 }
 
 
@@ -337,30 +782,46 @@ void GANOP::greyToVector(const std::vector<int>& grey_code, NetOper& nop) {
 void GANOP::evaluatePopulation() {
     int num_obj = config_.fitness_evaluator->getNumObjectives();
     
+    // Создаём решения из хромосом и оцениваем одним пакетом
+    std::vector<int> indices;
+    std::vector<std::unique_ptr<ISolution>> solutions;
+    std::vector<const ISolution*> batch;
     for (int i = 0; i < config_.population_size; ++i) {
-        // Создаём решение из хромосомы
+        if (fitness_known_[i]) {
+            continue;
+        }
+        
         auto solution = config_.solution_factory();
         solution->decode(population_params_[i], population_struct_[i]);
-        
-        // Вычисляем фитнесс
-        auto fitness = config_.fitness_evaluator->evaluate(*solution);
-        
+        batch.push_back(solution.get());
+        solutions.push_back(std::move(solution));
+        indices.push_back(i);
+    }
+    
+    auto results = config_.fitness_evaluator->evaluateBatch(batch);
+    
+    for (size_t k = 0; k < indices.size(); ++k) {
         // Проверка корректности размера
-        if (static_cast<int>(fitness.size()) != num_obj) {
+        if (k >= results.size() || static_cast<int>(results[k].size()) != num_obj) {
             throw std::runtime_error(
                 "Fitness function returned wrong number of objectives"
             );
         }
         
-        fitness_population_[i] = fitness;
+        fitness_population_.setRow(indices[k], results[k]);
     }
 }
 
+void GANOP::setRank(int index, int rank) {
+    pareto_ranks_[index] = rank;
+    rank_heap_.update(index, rank);
+}
+
 void GANOP::updateParetoRanks() {
     // Вычисляем ранг для каждой особи (количество особей, которые её доминируют)
-    for (int i = 0; i < config_.population_size; ++i) {
-        pareto_ranks_[i] = computeRank(fitness_population_[i]);
-    }
+    fitness_population_.dominationCounts(pareto_ranks_);
+    rank_heap_.assign(pareto_ranks_);
+    buildRankSelector();
     
     // Выбираем Парето-оптимальные (ранг = 0)
     pareto_indices_.clear();
@@ -372,46 +833,47 @@ void GANOP::updateParetoRanks() {
 }
 
 int GANOP::computeRank(const std::vector<float>& fitness) const {
-    int num_obj = config_.fitness_evaluator->getNumObjectives();
-    int domination_count = 0;
-    
-    for (int i = 0; i < config_.population_size; ++i) {
-        // Проверяем, доминирует ли особь i над текущей (fitness)
-        
-        // Шаг 1: проверяем, пока текущая особь не хуже, чем i
-        int j = 0;
-        while (j < num_obj && fitness[j] >= fitness_population_[i][j]) {
-            j++;
-        }
-        
-        // Если все критерии прошли (j == num_obj)
-        if (j >= num_obj) {
-            // Шаг 2: проверяем, не все ли равны
-            int k = 0;
-            while (k < num_obj && fitness[k] == fitness_population_[i][k]) {
-                k++;
-            }
-            
-            // Если не все равны (k < num_obj) - особь i доминирует текущую
-            if (k < num_obj) {
-                domination_count++;
-            }
-        }
+    // Количество особей популяции, доминирующих fitness (векторное ядро FitnessMatrix)
+    return fitness_population_.countDominating(fitness.data());
+}
+
+
+const std::vector<std::vector<int>>& GANOP::decodeMatrix(const std::vector<std::vector<int>>& structure) {
+    // Вариации накладываются на ту же матрицу, что в ISolution::decode: решение
+    // без вариаций из solution_factory (шаблон сети может быть другим, например загруженным)
+    if (decode_base_.empty()) {
+        auto base = config_.solution_factory();
+        base->decode(std::vector<int>(config_.num_params * (config_.int_bits + config_.frac_bits), 0), {});
+        decode_base_ = base->getNetOper().getPsi();
     }
-    
-    return domination_count;
+    variation_net_.setPsi(decode_base_);
+    for (const auto& variation : structure) {
+        variation_net_.Variations(variation);
+    }
+    return variation_net_.getPsi();
 }
 
+void GANOP::buildRankSelector() {
+    // Таблица по рангам на момент построения; замены внутри поколения её не меняют
+    if (config_.rank_selection_table) {
+        rank_selector_.build(pareto_ranks_, config_.search_neighbors + 1);
+    }
+}
 
-void GANOP::selectParents(int& parent1_idx, int& parent2_idx) {
-    std::uniform_int_distribution<int> dist_pop(0, config_.population_size - 1);
+void GANOP::selectParents(int& parent1_idx, int& parent2_idx, CounterRng& rng) {
+    if (!rank_selector_.empty()) {
+        // То же распределение, что у турнира ниже, за одну выборку
+        parent1_idx = rank_selector_.select(rng);
+        parent2_idx = rng.uniformInt(config_.population_size);
+        return;
+    }
     
     // Выбираем первого родителя с поиском в соседстве
-    parent1_idx = dist_pop(rng_);
+    parent1_idx = rng.uniformInt(config_.population_size);
     int best_rank = pareto_ranks_[parent1_idx];
     
     for (int i = 0; i < config_.search_neighbors; ++i) {
-        int candidate = dist_pop(rng_);
+        int candidate = rng.uniformInt(config_.population_size);
         if (pareto_ranks_[candidate] < best_rank) {
             parent1_idx = candidate;
             best_rank = pareto_ranks_[candidate];
@@ -419,23 +881,19 @@ void GANOP::selectParents(int& parent1_idx, int& parent2_idx) {
     }
     
     // Второго родителя выбираем просто случайно
-    parent2_idx = dist_pop(rng_);
+    parent2_idx = rng.uniformInt(config_.population_size);
 }
 
 void GANOP::crossover(int p1, int p2, 
                       std::vector<std::vector<int>>& offspring_params,
-                      std::vector<std::vector<std::vector<int>>>& offspring_struct) {
-    
-    std::uniform_int_distribution<int> dist_bit(0, 1);
-    std::uniform_int_distribution<int> dist_struct(0, config_.num_struct_variations - 1);
-    std::uniform_int_distribution<int> dist_param(0, config_.num_params * 
-                                                       (config_.int_bits + config_.frac_bits) - 1);
-    
-    int crossover_point_struct = dist_struct(rng_);
-    int crossover_point_param = dist_param(rng_);
+                      std::vector<std::vector<std::vector<int>>>& offspring_struct,
+                      CounterRng& rng) {
     
     int total_bits = config_.num_params * (config_.int_bits + config_.frac_bits);
     
+    int crossover_point_struct = rng.uniformInt(config_.num_struct_variations);
+    int crossover_point_param = rng.uniformInt(total_bits);
+    
     // Инициализация потомков
     for (int i = 0; i < 4; ++i) {
         offspring_params[i] = population_params_[i < 2 ? p1 : p2];
@@ -489,20 +947,33 @@ void GANOP::crossover(int p1, int p2,
 }
 
 void GANOP::mutate(std::vector<int>& chromosome_params,
-                   std::vector<std::vector<int>>& chromosome_struct) {
-    
-    std::uniform_int_distribution<int> dist_bit(0, 1);
-    std::uniform_int_distribution<int> dist_struct(0, config_.num_struct_variations - 1);
-    std::uniform_int_distribution<int> dist_param(0, static_cast<int>(chromosome_params.size()) - 1);
+                   std::vector<std::vector<int>>& chromosome_struct,
+                   CounterRng& rng) {
     
     // Мутация параметров (инвертирование случайного бита)
-    int mutant_bit = dist_param(rng_);
-    chromosome_params[mutant_bit] = dist_bit(rng_);  // ← Было: 1 - chromosome_params[mutant_bit]
+    int mutant_bit = rng.uniformInt(static_cast<int>(chromosome_params.size()));
+    chromosome_params[mutant_bit] = rng.uniformInt(2);  // ← Было: 1 - chromosome_params[mutant_bit]
     
     // Мутация структуры (генерация новой вариации через NOP.GenVar)
-    int mutant_struct = dist_struct(rng_);
+    int mutant_struct = rng.uniformInt(config_.num_struct_variations);
     
-    nop_template_.GenVar(chromosome_struct[mutant_struct]);
+    // Вариация может ничего не изменить в декодированной матрице (замена нулевой дуги,
+    // добавление поверх существующей, удаление единственной) - такой потомок повторил бы
+    // родителя. Считаем такие случаи, а в режиме effective_mutations перегенерируем вариацию
+    const std::vector<std::vector<int>> parent_matrix = decodeMatrix(chromosome_struct);
+    const int attempts = config_.effective_mutations ? EffectiveMutationAttempts : 1;
+    ++mutation_stats_.mutations;
+    for (int attempt = 1; ; ++attempt) {
+        nop_template_.GenVar(chromosome_struct[mutant_struct], rng);
+        if (decodeMatrix(chromosome_struct) != parent_matrix) {
+            break;
+        }
+        if (attempt >= attempts) {
+            ++mutation_stats_.noop_variations;
+            break;
+        }
+        ++mutation_stats_.resampled_variations;
+    }
     // Нужен доступ к NetOper для вызова GenVar
     // auto temp_solution = config_.solution_factory();
     // auto robot_sol = dynamic_cast<RobotSolution*>(temp_solution.get());
@@ -513,12 +984,297 @@ void GANOP::mutate(std::vector<int>& chromosome_params,
     // } else {
     //     // Fallback: случайная регенерация
     //     for (auto& bit : chromosome_struct[mutant_struct]) {
-    //         bit = dist_bit(rng_);
+    //         bit = rng.uniformInt(2);
     //     }
     // }
 }
 
 
+bool GANOP::saveParetoArchive(const std::string& filepath) const {
+    NetArchiveWriter writer;
+    const int num_obj = config_.fitness_evaluator->getNumObjectives();
+    if (!writer.open(filepath, static_cast<uint32_t>(num_obj), config_.fitness_evaluator->getConfigHash())) {
+        return false;
+    }
+    
+    for (int idx : pareto_indices_) {
+        auto solution = config_.solution_factory();
+        solution->decode(population_params_[idx], population_struct_[idx]);
+        if (!writer.add(solution->getNetOperConst(), fitness_population_.row(idx))) {
+            return false;
+        }
+    }
+    
+    return writer.close();
+}
+
+
+bool GANOP::saveEliteArchive(const std::string& filepath) const {
+    NetArchiveWriter writer;
+    const int num_obj = config_.fitness_evaluator->getNumObjectives();
+    if (!writer.open(filepath, static_cast<uint32_t>(num_obj), config_.fitness_evaluator->getConfigHash())) {
+        return false;
+    }
+    
+    for (const ParetoArchiveEntry* elite : elite_archive_.entries()) {
+        auto solution = config_.solution_factory();
+        solution->decode(elite->params, elite->structure);
+        if (!writer.add(solution->getNetOperConst(), elite->fitness)) {
+            return false;
+        }
+    }
+    
+    return writer.close();
+}
+
+
+void GANOP::offerElite(const std::vector<int>& params,
+                       const std::vector<std::vector<int>>& structure,
+                       const std::vector<float>& fitness) {
+    // Доминируемые и повторные решения отсекаются до копирования хромосомы
+    if (elite_archive_.isDominated(fitness)) {
+        return;
+    }
+    elite_archive_.insert(ParetoArchiveEntry{fitness, params, structure});
+}
+
+
+uint64_t GANOP::configHash() const {
+    ConfigHash hash;
+    hash.add(config_.population_size)
+        .add(config_.num_crossovers_per_gen)
+        .add(config_.mutation_prob)
+        .add(config_.selection_alpha)
+        .add(config_.search_neighbors)
+        .add(config_.rank_selection_table)
+        .add(config_.effective_mutations)
+        .add(config_.seed)
+        .add(config_.num_params)
+        .add(config_.int_bits)
+        .add(config_.frac_bits)
+        .add(config_.num_struct_variations)
+        .add(config_.nodes_for_vars)
+        .add(config_.nodes_for_params)
+        .add(config_.nodes_for_output)
+        .add(config_.fitness_evaluator->getNumObjectives())
+        .add(config_.fitness_evaluator->getConfigHash());
+    
+    std::vector<char> image;
+    if (config_.nop_template && config_.nop_template->toBinary(image)) {
+        hash.addBytes(image.data(), image.size());
+    }
+    return hash.value();
+}
+
+
+bool GANOP::checkpointDue(int generation) const {
+    if (config_.checkpoint_path.empty() || config_.checkpoint_interval <= 0) {
+        return false;
+    }
+    return generation % config_.checkpoint_interval == 0 || generation == config_.num_generations;
+}
+
+
+bool GANOP::saveCheckpoint(const std::string& filepath, int generation) const {
+    const int num_obj = config_.fitness_evaluator->getNumObjectives();
+    
+    CheckpointHeader header{};
+    std::memcpy(header.magic, CheckpointMagic, sizeof(header.magic));
+    header.version = CheckpointVersion;
+    header.generation = generation;
+    header.config_hash = configHash();
+    header.population_size = static_cast<uint32_t>(config_.population_size);
+    header.total_bits = static_cast<uint32_t>(config_.num_params * (config_.int_bits + config_.frac_bits));
+    header.num_struct_variations = static_cast<uint32_t>(config_.num_struct_variations);
+    header.num_objectives = static_cast<uint32_t>(num_obj);
+    
+    std::vector<char> data(sizeof(header));
+    
+    for (int i = 0; i < config_.population_size; ++i) {
+        appendChromosome(data, population_params_[i], population_struct_[i]);
+        for (float f : fitness_population_.row(i)) {
+            appendRaw(data, f);
+        }
+        appendRaw(data, static_cast<int32_t>(pareto_ranks_[i]));
+    }
+    
+    const auto elites = elite_archive_.entries();
+    appendRaw(data, static_cast<uint32_t>(elites.size()));
+    for (const ParetoArchiveEntry* elite : elites) {
+        appendChromosome(data, elite->params, elite->structure);
+        for (float f : elite->fitness) {
+            appendRaw(data, f);
+        }
+    }
+    
+    header.checksum = checksum32(data.data() + sizeof(header), data.size() - sizeof(header));
+    std::memcpy(data.data(), &header, sizeof(header));
+    
+    // Пишем во временный файл и переименовываем: прерванная запись
+    // не портит предыдущий чекпоинт
+    const std::string tmp_path = filepath + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "ERROR: Could not open checkpoint for writing: " << tmp_path << std::endl;
+            return false;
+        }
+        file.write(data.data(), data.size());
+        file.flush();
+        if (!file.good()) {
+            std::cerr << "ERROR: Failed to write checkpoint: " << tmp_path << std::endl;
+            return false;
+        }
+    }
+    
+    if (std::rename(tmp_path.c_str(), filepath.c_str()) != 0) {
+        std::cerr << "ERROR: Failed to replace checkpoint: " << filepath << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+bool GANOP::loadCheckpoint(const std::string& filepath, int& generation) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    
+    const char* it = data.data();
+    const char* end = data.data() + data.size();
+    
+    CheckpointHeader header{};
+    if (!readRaw(it, end, header) ||
+        std::memcmp(header.magic, CheckpointMagic, sizeof(header.magic)) != 0 ||
+        header.version != CheckpointVersion) {
+        std::cerr << "ERROR: Not a GANOP checkpoint (or unsupported version): " << filepath << std::endl;
+        return false;
+    }
+    if (checksum32(it, end - it) != header.checksum) {
+        std::cerr << "ERROR: Checkpoint checksum mismatch: " << filepath << std::endl;
+        return false;
+    }
+    
+    const int num_obj = config_.fitness_evaluator->getNumObjectives();
+    const uint32_t total_bits = static_cast<uint32_t>(config_.num_params * (config_.int_bits + config_.frac_bits));
+    if (header.config_hash != configHash() ||
+        header.population_size != static_cast<uint32_t>(config_.population_size) ||
+        header.total_bits != total_bits ||
+        header.num_struct_variations != static_cast<uint32_t>(config_.num_struct_variations) ||
+        header.num_objectives != static_cast<uint32_t>(num_obj)) {
+        std::cerr << "WARNING: Checkpoint " << filepath
+                  << " was made with a different configuration, ignoring it" << std::endl;
+        return false;
+    }
+    
+    // Читаем во временные массивы, чтобы не испортить популяцию при ошибке
+    auto params = population_params_;
+    auto structs = population_struct_;
+    auto fitness = fitness_population_;
+    auto ranks = pareto_ranks_;
+    
+    for (int i = 0; i < config_.population_size; ++i) {
+        if (!readChromosome(it, end, total_bits, config_.num_struct_variations, params[i], structs[i])) {
+            return false;
+        }
+        for (int k = 0; k < num_obj; ++k) {
+            float value = 0.0f;
+            if (!readRaw(it, end, value)) return false;
+            fitness.set(i, k, value);
+        }
+        int32_t rank = 0;
+        if (!readRaw(it, end, rank)) return false;
+        ranks[i] = rank;
+    }
+    
+    ParetoArchive elites(num_obj);
+    uint32_t num_elites = 0;
+    if (!readRaw(it, end, num_elites)) return false;
+    for (uint32_t e = 0; e < num_elites; ++e) {
+        ParetoArchiveEntry elite;
+        if (!readChromosome(it, end, total_bits, config_.num_struct_variations, elite.params, elite.structure)) {
+            return false;
+        }
+        elite.fitness.resize(num_obj);
+        for (int k = 0; k < num_obj; ++k) {
+            if (!readRaw(it, end, elite.fitness[k])) return false;
+        }
+        elites.insert(elite);
+    }
+    
+    population_params_.swap(params);
+    population_struct_.swap(structs);
+    fitness_population_ = std::move(fitness);
+    pareto_ranks_.swap(ranks);
+    elite_archive_ = std::move(elites);
+    rank_heap_.assign(pareto_ranks_);
+    buildRankSelector();
+    
+    pareto_indices_.clear();
+    for (int i = 0; i < config_.population_size; ++i) {
+        if (pareto_ranks_[i] == 0) {
+            pareto_indices_.push_back(i);
+        }
+    }
+    
+    generation = header.generation;
+    return true;
+}
+
+
+std::vector<Migrant> GANOP::emigrants(int count) const {
+    const int num_obj = config_.fitness_evaluator->getNumObjectives();
+    
+    std::vector<int> order = pareto_indices_;
+    std::sort(order.begin(), order.end(), [this, num_obj](int a, int b) {
+        return fitness_population_.at(a, num_obj - 1) < fitness_population_.at(b, num_obj - 1);
+    });
+    if (static_cast<int>(order.size()) > count) {
+        order.resize(std::max(count, 0));
+    }
+    
+    std::vector<Migrant> result;
+    result.reserve(order.size());
+    for (int idx : order) {
+        result.push_back(Migrant{population_params_[idx], population_struct_[idx], fitness_population_.row(idx)});
+    }
+    return result;
+}
+
+
+int GANOP::immigrate(const std::vector<Migrant>& migrants) {
+    const size_t num_obj = static_cast<size_t>(config_.fitness_evaluator->getNumObjectives());
+    int accepted = 0;
+    
+    // Как при замене потомками: мигрант занимает место особи с худшим рангом,
+    // если сам доминируется меньшим числом особей
+    for (const auto& migrant : migrants) {
+        if (migrant.fitness.size() != num_obj) {
+            continue;
+        }
+        
+        offerElite(migrant.params, migrant.structure, migrant.fitness);
+        int rank = computeRank(migrant.fitness);
+        const int worst_idx = rank_heap_.top();
+        if (rank < rank_heap_.topRank()) {
+            population_params_[worst_idx] = migrant.params;
+            population_struct_[worst_idx] = migrant.structure;
+            fitness_population_.setRow(worst_idx, migrant.fitness);
+            setRank(worst_idx, rank);
+            ++accepted;
+        }
+    }
+    
+    if (accepted > 0) {
+        updateParetoRanks();
+    }
+    return accepted;
+}
+
+
 int GANOP::getBestParetoIndex() const {
     if (pareto_indices_.empty()) {
         throw std::runtime_error("No Pareto solutions found!");
@@ -526,11 +1282,11 @@ int GANOP::getBestParetoIndex() const {
     
     int num_obj = config_.fitness_evaluator->getNumObjectives();
     int best_idx = pareto_indices_[0];
-    float best_value = fitness_population_[best_idx][num_obj - 1];
+    float best_value = fitness_population_.at(best_idx, num_obj - 1);
     
     for (int idx : pareto_indices_) {
-        if (fitness_population_[idx][num_obj - 1] < best_value) {
-            best_value = fitness_population_[idx][num_obj - 1];
+        if (fitness_population_.at(idx, num_obj - 1) < best_value) {
+            best_value = fitness_population_.at(idx, num_obj - 1);
             best_idx = idx;
         }
     }
@@ -249,4 +249,14 @@ float xi_7(float l, float r)
 float xi_8(float l, float r)
 {
 	return ro_10(l + r) * xi_2(fabs(l), fabs(r));
-}
\ No newline at end of file
+}
+
+float (*const UnaryFunctions[NumUnaryFunctions + 1])(float) = {
+	nullptr, ro_1, ro_2, ro_3, ro_4, ro_5, ro_6, ro_7, ro_8, ro_9, ro_10,
+	ro_11, ro_12, ro_13, ro_14, ro_15, ro_16, ro_17, ro_18, ro_19, ro_20,
+	ro_21, ro_22, ro_23, ro_24, ro_25, ro_26, ro_27, ro_28
+};
+
+float (*const BinaryFunctions[NumBinaryFunctions + 1])(float, float) = {
+	nullptr, xi_1, xi_2, xi_3, xi_4, xi_5, xi_6, xi_7, xi_8
+};
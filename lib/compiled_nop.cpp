@@ -0,0 +1,372 @@
+#include "compiled_nop.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+
+namespace {
+
+/// f(f(x)) = f(x): знак, насыщение [-1, 1], ступенька, знак с мёртвой зоной
+bool isIdempotent(int op)
+{
+    return op == 10 || op == 16 || op == 25 || op == 26;
+}
+
+/// xi(l, r) = xi(r, l) бит в бит (max/min нет: при равенстве и NaN результат зависит от порядка)
+bool isCommutative(int op)
+{
+    return op == 1 || op == 2 || op == 5 || op == 6 || op == 7 || op == 8;
+}
+
+uint32_t bitsOf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+bool sameOutput(float a, float b)
+{
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+}
+
+
+/**
+ * @brief Построитель программы: узлы в порядке создания, операнды всегда раньше
+ *
+ * С simplify = false узлы добавляются как есть (дословная компиляция),
+ * с simplify = true каждый новый узел проходит правила optimize()
+ */
+class NetProgramBuilder
+{
+public:
+    NetProgramBuilder(size_t num_inputs, bool simplify, PeepholeStats* stats = nullptr)
+        : m_numInputs(num_inputs), m_simplify(simplify), m_stats(stats ? stats : &m_unused)
+    {
+        for (size_t k = 0; k < num_inputs; ++k) {
+            m_nodes.push_back({Input, 0, static_cast<int>(k), -1, 0.0f});
+        }
+    }
+
+    int input(size_t index) const { return static_cast<int>(index); }
+
+    int constant(float value)
+    {
+        const uint32_t bits = bitsOf(value);
+        auto it = m_constants.find(bits);
+        if (it != m_constants.end()) {
+            return it->second;
+        }
+        const int id = push({Const, 0, -1, -1, value});
+        m_constants.emplace(bits, id);
+        return id;
+    }
+
+    int unary(int op, int a)
+    {
+        if (op < 1 || op > NumUnaryFunctions) {
+            throw std::invalid_argument("CompiledNetOper: unknown unary operation " + std::to_string(op));
+        }
+        if (!m_simplify) {
+            return push({Unary, op, a, -1, 0.0f});
+        }
+
+        const Node& operand = m_nodes[a];
+        if (op == 1) {
+            ++m_stats->identities;
+            return a;
+        }
+        if (operand.kind == Const) {
+            ++m_stats->folded;
+            return constant(UnaryFunctions[op](operand.value));
+        }
+        if (operand.kind == Unary && operand.op == op && isIdempotent(op)) {
+            ++m_stats->involutions;
+            return a;
+        }
+        if (operand.kind == Unary && operand.op == 3 && op == 3) {
+            ++m_stats->involutions;
+            return operand.a;
+        }
+        return shared({Unary, op, a, -1, 0.0f});
+    }
+
+    int binary(int op, int l, int r)
+    {
+        if (op < 1 || op > NumBinaryFunctions) {
+            throw std::invalid_argument("CompiledNetOper: unknown binary operation " + std::to_string(op));
+        }
+        if (!m_simplify) {
+            return push({Binary, op, l, r, 0.0f});
+        }
+
+        const Node& left = m_nodes[l];
+        const Node& right = m_nodes[r];
+        if (left.kind == Const && right.kind == Const) {
+            ++m_stats->folded;
+            return constant(BinaryFunctions[op](left.value, right.value));
+        }
+        if (op == 1 && left.kind == Const && left.value == 0.0f) {
+            ++m_stats->identities;
+            return r;
+        }
+        if (op == 1 && right.kind == Const && right.value == 0.0f) {
+            ++m_stats->identities;
+            return l;
+        }
+        if (isCommutative(op) && l > r) {
+            std::swap(l, r);
+        }
+        return shared({Binary, op, l, r, 0.0f});
+    }
+
+    /// Разложить узлы в программу; prune - выбросить не влияющие на выходы
+    void finish(const std::vector<int>& outputs, bool prune, CompiledNetOper& out)
+    {
+        std::vector<char> live(m_nodes.size(), prune ? 0 : 1);
+        for (int id : outputs) {
+            live[id] = 1;
+        }
+        for (size_t id = m_nodes.size(); id-- > 0;) {
+            const Node& node = m_nodes[id];
+            if (!live[id]) {
+                if (node.kind == Unary || node.kind == Binary) {
+                    ++m_stats->dead;
+                }
+                continue;
+            }
+            if (node.kind == Unary || node.kind == Binary) {
+                live[node.a] = 1;
+            }
+            if (node.kind == Binary) {
+                live[node.b] = 1;
+            }
+        }
+
+        out.m_constants.clear();
+        out.m_code.clear();
+        out.m_outputs.clear();
+        out.m_numInputs = m_numInputs;
+
+        std::vector<int> slot(m_nodes.size(), -1);
+        for (size_t id = 0; id < m_nodes.size(); ++id) {
+            if (live[id] && m_nodes[id].kind == Const) {
+                slot[id] = static_cast<int>(out.m_constants.size());
+                out.m_constants.push_back(m_nodes[id].value);
+            }
+        }
+        const int first_input = static_cast<int>(out.m_constants.size());
+        const int first_result = first_input + static_cast<int>(m_numInputs);
+        for (size_t id = 0; id < m_nodes.size(); ++id) {
+            const Node& node = m_nodes[id];
+            if (node.kind == Input) {
+                slot[id] = first_input + node.a;
+            } else if (live[id] && node.kind != Const) {
+                slot[id] = first_result + static_cast<int>(out.m_code.size());
+                out.m_code.push_back({static_cast<uint8_t>(node.kind == Binary),
+                                      static_cast<uint8_t>(node.op),
+                                      slot[node.a],
+                                      node.kind == Binary ? slot[node.b] : -1});
+            }
+        }
+        for (int id : outputs) {
+            out.m_outputs.push_back(slot[id]);
+        }
+
+        out.m_values.assign(first_result + out.m_code.size(), 0.0f);
+        std::copy(out.m_constants.begin(), out.m_constants.end(), out.m_values.begin());
+    }
+
+private:
+    enum Kind { Const, Input, Unary, Binary };
+
+    struct Node
+    {
+        Kind kind;
+        int op;
+        int a;        // номер входа для Input
+        int b;
+        float value;  // для Const
+    };
+
+    int push(const Node& node)
+    {
+        m_nodes.push_back(node);
+        return static_cast<int>(m_nodes.size()) - 1;
+    }
+
+    /// Узел с теми же операцией и операндами создаётся один раз
+    int shared(const Node& node)
+    {
+        const auto key = std::make_tuple(static_cast<int>(node.kind), node.op, node.a, node.b);
+        auto it = m_expressions.find(key);
+        if (it != m_expressions.end()) {
+            ++m_stats->merged;
+            return it->second;
+        }
+        const int id = push(node);
+        m_expressions.emplace(key, id);
+        return id;
+    }
+
+    size_t m_numInputs;
+    bool m_simplify;
+    PeepholeStats* m_stats;
+    PeepholeStats m_unused;   // статистика дословной компиляции не нужна
+    std::vector<Node> m_nodes;
+    std::unordered_map<uint32_t, int> m_constants;
+    std::map<std::tuple<int, int, int, int>, int> m_expressions;
+};
+
+
+CompiledNetOper::CompiledNetOper(const NetOper& net)
+{
+    compile(net);
+}
+
+void CompiledNetOper::compile(const NetOper& net)
+{
+    const auto& psi = net.getPsi();
+    const auto& vars = net.getNodesForVars();
+    const auto& params = net.getNodesForParams();
+    const auto& outputs = net.getNodesForOutput();
+    const auto& cs = net.getCs();
+    const int size = static_cast<int>(psi.size());
+
+    for (const auto& row : psi) {
+        if (static_cast<int>(row.size()) != size) {
+            throw std::invalid_argument("CompiledNetOper: matrix must be square");
+        }
+    }
+    auto checkNodes = [size](const std::vector<int>& nodes) {
+        for (int node : nodes) {
+            if (node < 0 || node >= size) {
+                throw std::invalid_argument("CompiledNetOper: node " + std::to_string(node) + " is outside the matrix");
+            }
+        }
+    };
+    checkNodes(vars);
+    checkNodes(params);
+    checkNodes(outputs);
+    if (cs.size() < params.size()) {
+        throw std::invalid_argument("CompiledNetOper: fewer parameters than parameter nodes");
+    }
+
+    NetProgramBuilder builder(vars.size(), false);
+
+    // Начальные значения узлов - как в NetOper::calcResult
+    std::vector<int> current(size);
+    for (int i = 0; i < size; ++i) {
+        const int op = psi[i][i];
+        const float init = op == 2 ? 1.0f : op == 3 ? -Infinity : op == 4 ? Infinity : 0.0f;
+        current[i] = builder.constant(init);
+    }
+    for (size_t k = 0; k < vars.size(); ++k) {
+        current[vars[k]] = builder.input(k);
+    }
+    for (size_t k = 0; k < params.size(); ++k) {
+        current[params[k]] = builder.constant(cs[k]);
+    }
+
+    for (int i = 0; i + 1 < size; ++i) {
+        for (int j = i + 1; j < size; ++j) {
+            if (psi[i][j] == 0) {
+                continue;
+            }
+            const int arc = builder.unary(psi[i][j], current[i]);
+            current[j] = builder.binary(psi[j][j], current[j], arc);
+        }
+    }
+
+    std::vector<int> result;
+    for (int node : outputs) {
+        result.push_back(current[node]);
+    }
+    builder.finish(result, false, *this);
+}
+
+PeepholeStats CompiledNetOper::optimize()
+{
+    PeepholeStats stats;
+    stats.instructions_before = m_code.size();
+
+    NetProgramBuilder builder(m_numInputs, true, &stats);
+    const size_t first_input = m_constants.size();
+    const size_t first_result = first_input + m_numInputs;
+
+    std::vector<int> map(first_result + m_code.size());
+    for (size_t c = 0; c < m_constants.size(); ++c) {
+        map[c] = builder.constant(m_constants[c]);
+    }
+    for (size_t k = 0; k < m_numInputs; ++k) {
+        map[first_input + k] = builder.input(k);
+    }
+    for (size_t k = 0; k < m_code.size(); ++k) {
+        const Instruction& in = m_code[k];
+        map[first_result + k] = in.binary ? builder.binary(in.op, map[in.a], map[in.b])
+                                          : builder.unary(in.op, map[in.a]);
+    }
+
+    std::vector<int> outputs;
+    for (int value : m_outputs) {
+        outputs.push_back(map[value]);
+    }
+    builder.finish(outputs, true, *this);
+
+    stats.instructions_after = m_code.size();
+    return stats;
+}
+
+void CompiledNetOper::calcResult(const float* x_in, float* y_out)
+{
+    float* values = m_values.data();
+    float* inputs = values + m_constants.size();
+    for (size_t k = 0; k < m_numInputs; ++k) {
+        inputs[k] = x_in[k];
+    }
+
+    float* result = inputs + m_numInputs;
+    for (const Instruction& in : m_code) {
+        *result++ = in.binary ? BinaryFunctions[in.op](values[in.a], values[in.b])
+                              : UnaryFunctions[in.op](values[in.a]);
+    }
+
+    for (size_t k = 0; k < m_outputs.size(); ++k) {
+        y_out[k] = values[m_outputs[k]];
+    }
+}
+
+
+bool verifyCompiled(NetOper& net, CompiledNetOper& program, int samples, float range, uint64_t seed)
+{
+    if (program.numInputs() != net.getNodesForVars().size() ||
+        program.numOutputs() != net.getNodesForOutput().size()) {
+        return false;
+    }
+
+    std::vector<float> x(program.numInputs());
+    std::vector<float> expected(program.numOutputs());
+    std::vector<float> actual(program.numOutputs());
+    for (int s = 0; s < samples; ++s) {
+        CounterRng rng(seed, 0, static_cast<uint32_t>(s), RngPurpose::Verification);
+        for (float& value : x) {
+            value = (2.0f * rng.uniformReal() - 1.0f) * range;
+        }
+        net.calcResult(x.data(), expected.data());
+        program.calcResult(x.data(), actual.data());
+        for (size_t k = 0; k < expected.size(); ++k) {
+            if (!sameOutput(expected[k], actual[k])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -1,15 +1,47 @@
 #include "controller.hpp"
 
+#include <stdexcept>
+
+namespace {
+
+/// Сеть получает (dx, dy, dyaw) - последние входы может не использовать - и выдаёт управления двух колёс
+constexpr size_t MaxControllerInputs = 3;
+constexpr size_t NumControllerOutputs = 2;
+
+void checkArity(const NetOper& netOper)
+{
+	if (netOper.getNodesForVars().size() > MaxControllerInputs ||
+		netOper.getNodesForOutput().size() != NumControllerOutputs)
+		throw std::invalid_argument("Controller: network must have at most 3 input and exactly 2 output nodes, got " +
+			std::to_string(netOper.getNodesForVars().size()) + " and " +
+			std::to_string(netOper.getNodesForOutput().size()));
+}
+
+}
+
 Controller::Controller(const Model::State &goalState, NetOper &netOper):
 	m_goal(goalState),
 	m_netOper(netOper)
-	{ }
+	{
+		// пустую сеть можно заполнить позже через netOper()
+		if (!netOper.getNodesForVars().empty() || !netOper.getNodesForOutput().empty())
+			checkArity(netOper);
+	}
 
 Model::Control Controller::calcControl(const Model::State& currState)
 {	
 	Model::State delta = m_goal - currState; 
-	std::vector<float> u(2, 0);
-	m_netOper.calcResult({delta.x, delta.y, delta.yaw}, u);
+	const std::array<float, 3> x = {delta.x, delta.y, delta.yaw};
+	std::array<float, 2> u = {0.0f, 0.0f};
+	if (m_compiled)
+		m_program.calcResult(x.data(), u.data());
+	else
+	{
+		// после записи через netOper() размерность не проверена
+		checkArity(m_netOper);
+		m_netOper.calcResult(x.data(), u.data());
+	}
+	m_rawControl = Model::Control{u[0], u[1]};
   	u[0] = std::min(std::max(u[0], -Umax), Umax);
   	u[1] = std::min(std::max(u[1], -Umax), Umax);
 
@@ -22,11 +54,46 @@ void Controller::setGoal(Model::State newGoal)
 	m_goal = newGoal;
 }
 
+const Model::State& Controller::goal() const
+{
+	return m_goal;
+}
+
+const Model::Control& Controller::rawControl() const
+{
+	return m_rawControl;
+}
+
 NetOper& Controller::netOper()
 {
+	m_compiled = false;
 	return m_netOper;
 }
 
+void Controller::setNetOper(const NetOper& netOper)
+{
+	if (m_compiled && m_netOper.getPsi() == netOper.getPsi() && m_netOper.getCs() == netOper.getCs() &&
+		m_netOper.getNodesForVars() == netOper.getNodesForVars() &&
+		m_netOper.getNodesForParams() == netOper.getNodesForParams() &&
+		m_netOper.getNodesForOutput() == netOper.getNodesForOutput())
+		return;
+
+	// Проверка и компиляция до замены: отклонённая сеть не попадает ни в программу,
+	// ни в интерпретатор (compile при ошибке не меняет m_program)
+	checkArity(netOper);
+	m_program.compile(netOper);
+	m_program.optimize();
+
+	// Копируются только данные сети (вектора той же длины не перевыделяются),
+	// таблицы функций m_netOper уже заполнены конструктором
+	m_netOper.setPsi(netOper.getPsi());
+	m_netOper.setCs(netOper.getCs());
+	m_netOper.setNodesForVars(netOper.getNodesForVars());
+	m_netOper.setNodesForParams(netOper.getNodesForParams());
+	m_netOper.setNodesForOutput(netOper.getNodesForOutput());
+	m_compiled = true;
+}
+
 void Controller::setUMax(float newUMax)
 {
 	if(newUMax == Umax) return;
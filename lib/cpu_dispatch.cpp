@@ -0,0 +1,108 @@
+#include "cpu_dispatch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+
+
+namespace {
+
+constexpr int Unset = -1;
+
+std::atomic<int> g_activeIsa{Unset};
+
+CpuIsa clampToDetected(CpuIsa isa)
+{
+    const CpuIsa detected = detectCpuIsa();
+    if (static_cast<int>(isa) > static_cast<int>(detected)) {
+        std::cerr << "WARNING: " << cpuIsaName(isa) << " is not supported by this CPU, using "
+                  << cpuIsaName(detected) << std::endl;
+        return detected;
+    }
+    return isa;
+}
+
+CpuIsa initialIsa()
+{
+    const char* env = std::getenv("NOP_ISA");
+    if (env == nullptr || *env == '\0') {
+        return detectCpuIsa();
+    }
+    CpuIsa isa;
+    if (!parseCpuIsa(env, isa)) {
+        std::cerr << "WARNING: Unknown NOP_ISA value '" << env << "', expected scalar, sse2, avx2 or avx512" << std::endl;
+        return detectCpuIsa();
+    }
+    return clampToDetected(isa);
+}
+
+}
+
+
+CpuIsa detectCpuIsa()
+{
+#if NOP_CPU_DISPATCH
+    // Проверка учитывает и поддержку ОС (сохранение регистров AVX через XGETBV)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return CpuIsa::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return CpuIsa::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return CpuIsa::SSE2;
+    }
+#endif
+    return CpuIsa::Scalar;
+}
+
+CpuIsa activeCpuIsa()
+{
+    int isa = g_activeIsa.load(std::memory_order_relaxed);
+    if (isa == Unset) {
+        // Гонка первых вызовов безопасна: все потоки вычислят одно и то же
+        int expected = Unset;
+        g_activeIsa.compare_exchange_strong(expected, static_cast<int>(initialIsa()));
+        isa = g_activeIsa.load(std::memory_order_relaxed);
+    }
+    return static_cast<CpuIsa>(isa);
+}
+
+CpuIsa setActiveCpuIsa(CpuIsa isa)
+{
+    isa = clampToDetected(isa);
+    g_activeIsa.store(static_cast<int>(isa), std::memory_order_relaxed);
+    return isa;
+}
+
+const char* cpuIsaName(CpuIsa isa)
+{
+    switch (isa) {
+    case CpuIsa::Scalar:
+        return "scalar";
+    case CpuIsa::SSE2:
+        return "sse2";
+    case CpuIsa::AVX2:
+        return "avx2";
+    case CpuIsa::AVX512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+bool parseCpuIsa(const std::string& name, CpuIsa& isa)
+{
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (CpuIsa candidate : {CpuIsa::Scalar, CpuIsa::SSE2, CpuIsa::AVX2, CpuIsa::AVX512}) {
+        if (lower == cpuIsaName(candidate)) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,174 @@
+#include "fingerprint_evaluator.hpp"
+#include "config_hash.hpp"
+#include "counter_rng.hpp"
+#include "nop.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+
+namespace {
+
+/// Ключ пробных входов: одинаковый во всех запусках, чтобы отпечатки были сравнимы
+constexpr uint64_t ProbeSeed = 0x4E4F5046ull;   // "NOPF"
+
+int64_t quantize(float value, float quantum)
+{
+    if (std::isnan(value)) {
+        return std::numeric_limits<int64_t>::min();
+    }
+    const double q = std::round(static_cast<double>(value) / quantum);
+    const double limit = 9.0e18;
+    return static_cast<int64_t>(std::max(-limit, std::min(limit, q)));
+}
+
+}
+
+
+FingerprintEvaluator::FingerprintEvaluator(std::shared_ptr<IFitnessEvaluator> inner, const FingerprintConfig& config)
+    : m_inner(std::move(inner)), m_config(config)
+{
+    if (!m_inner) {
+        throw std::invalid_argument("FingerprintEvaluator: inner evaluator must be provided");
+    }
+    if (m_config.quantum <= 0.0f) {
+        throw std::invalid_argument("FingerprintEvaluator: quantum must be > 0");
+    }
+}
+
+std::vector<float> FingerprintEvaluator::evaluate(const ISolution& solution)
+{
+    return evaluateBatch({&solution}).front();
+}
+
+std::vector<std::vector<float>> FingerprintEvaluator::evaluateBatch(const std::vector<const ISolution*>& solutions)
+{
+    if (m_config.num_probes <= 0) {
+        return m_inner->evaluateBatch(solutions);
+    }
+
+    const size_t n = solutions.size();
+    std::vector<std::vector<int64_t>> outputs(n);
+    std::vector<uint64_t> keys(n);
+    std::vector<std::vector<float>> results(n);
+    std::vector<int> source(n, -1);          // номер в misses, откуда взять фитнес
+    std::vector<const ISolution*> misses;
+    std::vector<size_t> miss_owner;          // индекс решения, давшего промах
+
+    for (size_t i = 0; i < n; ++i) {
+        outputs[i] = probe(solutions[i]->getNetOperConst());
+        keys[i] = hash(outputs[i]);
+        if (lookup(keys[i], outputs[i], results[i])) {
+            continue;
+        }
+
+        // Повтор внутри пакета оценивается один раз
+        for (size_t k = 0; k < misses.size(); ++k) {
+            const size_t owner = miss_owner[k];
+            if (keys[owner] == keys[i] && (!m_config.verify || outputs[owner] == outputs[i])) {
+                source[i] = static_cast<int>(k);
+                break;
+            }
+        }
+        if (source[i] >= 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_stats.hits;
+            continue;
+        }
+
+        source[i] = static_cast<int>(misses.size());
+        misses.push_back(solutions[i]);
+        miss_owner.push_back(i);
+    }
+
+    if (!misses.empty()) {
+        {
+            // Промах - только то, что действительно уходит во внутренний evaluator
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.misses += static_cast<long>(misses.size());
+        }
+        const auto fresh = m_inner->evaluateBatch(misses);
+        for (size_t k = 0; k < misses.size() && k < fresh.size(); ++k) {
+            store(keys[miss_owner[k]], outputs[miss_owner[k]], fresh[k]);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (source[i] >= 0 && static_cast<size_t>(source[i]) < fresh.size()) {
+                results[i] = fresh[source[i]];
+            }
+        }
+    }
+    return results;
+}
+
+FingerprintStats FingerprintEvaluator::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+std::vector<int64_t> FingerprintEvaluator::probe(const NetOper& net) const
+{
+    // calcResult меняет рабочий вектор z, поэтому считаем на копии
+    NetOper copy = net;
+    const size_t num_inputs = copy.getNodesForVars().size();
+    const size_t num_outputs = copy.getNodesForOutput().size();
+
+    std::vector<float> x(num_inputs);
+    std::vector<float> y(num_outputs);
+    std::vector<int64_t> result;
+    result.reserve(static_cast<size_t>(m_config.num_probes) * num_outputs);
+
+    for (int p = 0; p < m_config.num_probes; ++p) {
+        CounterRng rng(ProbeSeed, 0, static_cast<uint32_t>(p), RngPurpose::Fingerprint);
+        for (float& value : x) {
+            value = (2.0f * rng.uniformReal() - 1.0f) * m_config.probe_range;
+        }
+        copy.calcResult(x.data(), y.data());
+        for (float value : y) {
+            result.push_back(quantize(value, m_config.quantum));
+        }
+    }
+    return result;
+}
+
+uint64_t FingerprintEvaluator::hash(const std::vector<int64_t>& outputs)
+{
+    ConfigHash hash;
+    hash.add(outputs);
+    return hash.value();
+}
+
+bool FingerprintEvaluator::lookup(uint64_t key, const std::vector<int64_t>& outputs, std::vector<float>& fitness)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_cache.find(key);
+    if (it == m_cache.end()) {
+        return false;
+    }
+    if (m_config.verify && it->second.outputs != outputs) {
+        ++m_stats.collisions;
+        return false;
+    }
+    fitness = it->second.fitness;
+    ++m_stats.hits;
+    return true;
+}
+
+void FingerprintEvaluator::store(uint64_t key, std::vector<int64_t> outputs, const std::vector<float>& fitness)
+{
+    if (fitness.size() != static_cast<size_t>(m_inner->getNumObjectives())) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_cache.size() >= m_config.max_entries) {
+        m_cache.clear();
+    }
+    Entry& entry = m_cache[key];
+    if (m_config.verify) {
+        entry.outputs = std::move(outputs);
+    }
+    entry.fitness = fitness;
+}
@@ -0,0 +1,179 @@
+#include "fitness_matrix.hpp"
+#include "cpu_dispatch.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#if NOP_CPU_DISPATCH
+#include <immintrin.h>
+#endif
+
+
+namespace {
+
+// Ядра доминирования: особь доминирует candidate, если candidate >= f по всем критериям
+// и > хотя бы по одному. Сравнения с NaN ложны, поэтому NaN-дополнение и NaN в фитнесе
+// не доминируют. Векторные ядра проходят stride особей блоками своей ширины
+using DominanceKernel = int (*)(const float* data, size_t stride, size_t size,
+                                size_t num_objectives, const float* candidate);
+
+int countDominatingScalar(const float* data, size_t stride, size_t size,
+                          size_t num_objectives, const float* candidate)
+{
+    int count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        bool not_worse = true;
+        bool better = false;
+        for (size_t j = 0; j < num_objectives && not_worse; ++j) {
+            const float value = data[j * stride + i];
+            not_worse = candidate[j] >= value;
+            better = better || candidate[j] > value;
+        }
+        if (not_worse && better) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+#if NOP_CPU_DISPATCH
+
+__attribute__((target("sse2")))
+int countDominatingSse2(const float* data, size_t stride, size_t,
+                        size_t num_objectives, const float* candidate)
+{
+    int count = 0;
+    for (size_t base = 0; base < stride; base += 4) {
+        __m128 not_worse = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+        __m128 better = _mm_setzero_ps();
+        for (size_t j = 0; j < num_objectives; ++j) {
+            const __m128 values = _mm_load_ps(data + j * stride + base);
+            const __m128 c = _mm_set1_ps(candidate[j]);
+            not_worse = _mm_and_ps(not_worse, _mm_cmpge_ps(c, values));
+            better = _mm_or_ps(better, _mm_cmpgt_ps(c, values));
+        }
+        count += __builtin_popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_and_ps(not_worse, better))));
+    }
+    return count;
+}
+
+__attribute__((target("avx2")))
+int countDominatingAvx2(const float* data, size_t stride, size_t,
+                        size_t num_objectives, const float* candidate)
+{
+    int count = 0;
+    for (size_t base = 0; base < stride; base += 8) {
+        __m256 not_worse = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        __m256 better = _mm256_setzero_ps();
+        for (size_t j = 0; j < num_objectives; ++j) {
+            const __m256 values = _mm256_load_ps(data + j * stride + base);
+            const __m256 c = _mm256_set1_ps(candidate[j]);
+            not_worse = _mm256_and_ps(not_worse, _mm256_cmp_ps(c, values, _CMP_GE_OQ));
+            better = _mm256_or_ps(better, _mm256_cmp_ps(c, values, _CMP_GT_OQ));
+        }
+        count += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_and_ps(not_worse, better))));
+    }
+    return count;
+}
+
+__attribute__((target("avx512f")))
+int countDominatingAvx512(const float* data, size_t stride, size_t,
+                          size_t num_objectives, const float* candidate)
+{
+    // Маски сравнения сразу в k-регистрах, блок = FitnessMatrix::Lanes особей
+    int count = 0;
+    for (size_t base = 0; base < stride; base += 16) {
+        __mmask16 not_worse = 0xFFFF;
+        __mmask16 better = 0;
+        for (size_t j = 0; j < num_objectives; ++j) {
+            const __m512 values = _mm512_load_ps(data + j * stride + base);
+            const __m512 c = _mm512_set1_ps(candidate[j]);
+            not_worse = _mm512_mask_cmp_ps_mask(not_worse, c, values, _CMP_GE_OQ);
+            better = static_cast<__mmask16>(better | _mm512_cmp_ps_mask(c, values, _CMP_GT_OQ));
+        }
+        count += __builtin_popcount(static_cast<unsigned>(not_worse & better));
+    }
+    return count;
+}
+
+#endif
+
+DominanceKernel dominanceKernel(CpuIsa isa)
+{
+#if NOP_CPU_DISPATCH
+    switch (isa) {
+    case CpuIsa::AVX512:
+        return countDominatingAvx512;
+    case CpuIsa::AVX2:
+        return countDominatingAvx2;
+    case CpuIsa::SSE2:
+        return countDominatingSse2;
+    case CpuIsa::Scalar:
+        break;
+    }
+#else
+    (void)isa;
+#endif
+    return countDominatingScalar;
+}
+
+}
+
+constexpr size_t FitnessMatrix::Lanes;
+constexpr size_t FitnessMatrix::Alignment;
+
+
+void FitnessMatrix::resize(size_t size, size_t num_objectives)
+{
+    m_size = size;
+    m_numObjectives = num_objectives;
+    m_stride = (size + Lanes - 1) / Lanes * Lanes;
+
+    m_data.assign(m_stride * num_objectives, std::numeric_limits<float>::quiet_NaN());
+    for (size_t j = 0; j < num_objectives; ++j) {
+        std::fill_n(m_data.begin() + j * m_stride, size, 0.0f);
+    }
+}
+
+std::vector<float> FitnessMatrix::row(size_t individual) const
+{
+    std::vector<float> result(m_numObjectives);
+    for (size_t j = 0; j < m_numObjectives; ++j) {
+        result[j] = at(individual, j);
+    }
+    return result;
+}
+
+void FitnessMatrix::setRow(size_t individual, const float* fitness)
+{
+    for (size_t j = 0; j < m_numObjectives; ++j) {
+        set(individual, j, fitness[j]);
+    }
+}
+
+std::vector<std::vector<float>> FitnessMatrix::rows() const
+{
+    std::vector<std::vector<float>> result(m_size);
+    for (size_t i = 0; i < m_size; ++i) {
+        result[i] = row(i);
+    }
+    return result;
+}
+
+int FitnessMatrix::countDominating(const float* candidate) const
+{
+    return dominanceKernel(activeCpuIsa())(m_data.data(), m_stride, m_size, m_numObjectives, candidate);
+}
+
+void FitnessMatrix::dominationCounts(std::vector<int>& ranks) const
+{
+    ranks.resize(m_size);
+    const DominanceKernel kernel = dominanceKernel(activeCpuIsa());
+    std::vector<float> candidate(m_numObjectives);
+    for (size_t i = 0; i < m_size; ++i) {
+        for (size_t j = 0; j < m_numObjectives; ++j) {
+            candidate[j] = at(i, j);
+        }
+        ranks[i] = kernel(m_data.data(), m_stride, m_size, m_numObjectives, candidate.data());
+    }
+}
@@ -6,6 +6,7 @@
 #include "ifitness_evaluator.hpp"
 #include "isolution.hpp"
 #include <random>
+#include <string>
 
 struct GAConfig {
     // === Параметры GA (универсальные) ===
@@ -15,6 +16,8 @@ struct GAConfig {
     float mutation_prob = 0.4f;
     float selection_alpha = 0.7f;
     int search_neighbors = 8;
+    bool rank_selection_table = true;   // отбор по таблице с распределением турнира за O(1); false - сам турнир
+    bool effective_mutations = false;   // мутация структуры всегда меняет декодированную матрицу
     uint32_t seed = std::mt19937::default_seed;
     
     // === Кодирование хромосом ===
@@ -30,6 +33,30 @@ struct GAConfig {
 
     std::shared_ptr<NetOper> nop_template;
 
+    // Архив Парето-фронта (*.nar), сохраняется в конце run(); пусто - не сохранять
+    std::string pareto_archive_path;
+    
+    // Архив элиты (*.nar) - все недоминируемые решения за запуск, сохраняется в конце run()
+    std::string elite_archive_path;
+    
+    // Архив сетей (*.nar) для начальной популяции; пусто - только шаблон и случайные особи.
+    // Сохранённый фитнес используется без переоценки, если совпадает хэш evaluator'а
+    std::string warm_start_archive;
+    
+    // === Асинхронный steady-state режим ===
+    // Потомки оцениваются пулом потоков, каждый готовый результат сразу заменяет худшую особь,
+    // новые потомки порождаются по мере освобождения потоков. Поколение = num_crossovers_per_gen * 4 оценок
+    bool asynchronous = false;
+    int async_workers = 0;   // 0 - по числу ядер
+    
+    // === Чекпоинты ===
+    // Файл чекпоинта; пусто - чекпоинты выключены
+    std::string checkpoint_path;
+    // Сохранять каждые N поколений (поколение 0 и последнее сохраняются всегда)
+    int checkpoint_interval = 1;
+    // Продолжить с чекпоинта, если он есть и совпадает хэш конфигурации
+    bool resume_from_checkpoint = true;
+
     // === Интерфейсы (инъекция зависимостей) ===
     std::shared_ptr<IFitnessEvaluator> fitness_evaluator;
     std::function<std::unique_ptr<ISolution>()> solution_factory;
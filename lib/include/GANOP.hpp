@@ -1,12 +1,31 @@
 // GANOP.hpp
 #pragma once
 #include "GAConfig.hpp"
+#include "counter_rng.hpp"
+#include "fitness_matrix.hpp"
 #include "nop.hpp"
+#include "pareto_archive.hpp"
+#include "rank_heap.hpp"
+#include "rank_selection.hpp"
 // #include "RobotSolution.hpp"
 #include "isolution.hpp"
 #include <vector>
 #include <memory>
 
+/// Статистика структурных мутаций за запуск
+struct MutationStats {
+    long mutations = 0;             // вызовов mutate()
+    long noop_variations = 0;       // потомок остался с той же матрицей, что до мутации
+    long resampled_variations = 0;  // вариаций, отброшенных в режиме effective_mutations
+};
+
+/// Особь для обмена между популяциями (островная модель)
+struct Migrant {
+    std::vector<int> params;
+    std::vector<std::vector<int>> structure;
+    std::vector<float> fitness;
+};
+
 class GANOP {
 public:
     explicit GANOP(const GAConfig& config);
@@ -14,24 +33,79 @@ public:
     // Запуск алгоритма
     void run();
     
+    // Пошаговый запуск: run() = initialize() + runGeneration(first..num_generations) + finish()
+    int initialize();                    // возвращает первое поколение главного цикла
+    void runGeneration(int generation);
+    void finish();
+    
+    // Миграция: лучшие Парето-оптимальные особи (по последнему критерию)
+    // и приём чужих особей на места худших, возвращает число принятых
+    std::vector<Migrant> emigrants(int count) const;
+    int immigrate(const std::vector<Migrant>& migrants);
+    
     // Получение результатов
     const std::vector<int>& getParetoIndices() const { return pareto_indices_; }
     int getBestParetoIndex() const;
-    const std::vector<std::vector<float>>& getAllFitness() const { return fitness_population_; }
+    const MutationStats& getMutationStats() const { return mutation_stats_; }
+    std::vector<std::vector<float>> getAllFitness() const { return fitness_population_.rows(); }
+    const FitnessMatrix& getFitnessMatrix() const { return fitness_population_; }
+    
+    // Сохранение Парето-оптимальных сетей с их фитнесом в архив (*.nar)
+    bool saveParetoArchive(const std::string& filepath) const;
+    
+    // Архив элиты: все недоминируемые решения, оценённые за запуск
+    // (в том числе вытесненные из популяции); сохраняется в elite_archive_path
+    const ParetoArchive& getEliteArchive() const { return elite_archive_; }
+    bool saveEliteArchive(const std::string& filepath) const;
+    
+    // Хэш параметров кодирования, GA, шаблона и evaluator'а
+    uint64_t configHash() const;
+    
+    // Чекпоинт: хромосомы, фитнес, ранги, архив элиты, номер поколения.
+    // Запись атомарная (временный файл + rename)
+    bool saveCheckpoint(const std::string& filepath, int generation) const;
+    bool loadCheckpoint(const std::string& filepath, int& generation);
     
 private:
     // === Внутренние методы GA ===
     void greyToVector(const std::vector<int>& grey_code, NetOper& nop);
     void vectorToGrey(std::vector<int>& grey_code, NetOper& nop);
     void initializePopulation();
+    int seedFromArchive(const std::string& filepath);
+    bool encodeNetwork(NetOper& net, std::vector<int>& chromosome_params,
+                       std::vector<std::vector<int>>& chromosome_struct);
     void evaluatePopulation();
     void updateParetoRanks();
-    void selectParents(int& parent1_idx, int& parent2_idx);
+    void setRank(int index, int rank);   // ранг одной особи вместе с кучей рангов
+    void offerElite(const std::vector<int>& params,
+                    const std::vector<std::vector<int>>& structure,
+                    const std::vector<float>& fitness);
+    const std::vector<std::vector<int>>& decodeMatrix(const std::vector<std::vector<int>>& structure);
+    void buildRankSelector();
+    void selectParents(int& parent1_idx, int& parent2_idx, CounterRng& rng);
     void crossover(int p1, int p2, std::vector<std::vector<int>>& offspring_params,
-                   std::vector<std::vector<std::vector<int>>>& offspring_struct);
+                   std::vector<std::vector<std::vector<int>>>& offspring_struct,
+                   CounterRng& rng);
     void mutate(std::vector<int>& chromosome_params,
-                std::vector<std::vector<int>>& chromosome_struct);
+                std::vector<std::vector<int>>& chromosome_struct,
+                CounterRng& rng);
     int computeRank(const std::vector<float>& fitness) const;
+    bool breedOffspring(int generation, int index,
+                        std::vector<std::vector<int>>& offspring_params,
+                        std::vector<std::vector<std::vector<int>>>& offspring_struct);
+    bool insertOffspring(const std::vector<int>& params,
+                         const std::vector<std::vector<int>>& structure,
+                         const std::vector<float>& fitness, int rank,
+                         int generation, int index);
+    void reportGeneration(int generation);
+    void runAsynchronous(int first_generation);
+    bool checkpointDue(int generation) const;
+    
+    // Случайные числа: поток (seed, поколение, номер скрещивания/потомка, назначение)
+    CounterRng makeRng(int generation, int index, RngPurpose purpose) const {
+        return CounterRng(config_.seed, static_cast<uint32_t>(generation),
+                          static_cast<uint32_t>(index), purpose);
+    }
     
     // === Члены класса ===
     GAConfig config_;
@@ -41,12 +115,16 @@ private:
     std::vector<std::vector<std::vector<int>>> population_struct_; // [HH][lchr][...]
     
     // Фитнесс и ранги
-    std::vector<std::vector<float>> fitness_population_;  // [HH][num_objectives]
+    FitnessMatrix fitness_population_;                    // [num_objectives][HH], выровнено
     std::vector<int> pareto_ranks_;                       // [HH]
+    RankHeap rank_heap_;                                  // куча по pareto_ranks_ для поиска худшей особи
+    RankSelector rank_selector_;                          // таблица отбора первого родителя на поколение
+    ParetoArchive elite_archive_;                         // недоминируемые решения за весь запуск
     std::vector<int> pareto_indices_;                     // индексы Парето-оптимальных
-    
-    // Генератор случайных чисел
-    std::mt19937 rng_;
+    std::vector<char> fitness_known_;                     // [HH] фитнес взят из архива, оценка не нужна
 
     NetOper nop_template_;
+    NetOper variation_net_;                               // декодирование матрицы в mutate()
+    std::vector<std::vector<int>> decode_base_;           // матрица решения без вариаций
+    MutationStats mutation_stats_;
 };
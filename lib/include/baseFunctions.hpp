@@ -47,3 +47,10 @@ float xi_5(float l, float r);
 float xi_6(float l, float r);
 float xi_7(float l, float r);
 float xi_8(float l, float r);
+
+constexpr int NumUnaryFunctions = 28;
+constexpr int NumBinaryFunctions = 8;
+
+// Функции по номеру операции в матрице (элемент 0 не используется)
+extern float (*const UnaryFunctions[NumUnaryFunctions + 1])(float);
+extern float (*const BinaryFunctions[NumBinaryFunctions + 1])(float, float);
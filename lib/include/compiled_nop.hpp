@@ -0,0 +1,100 @@
+#pragma once
+
+#include "nop.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/// Сколько раз сработало каждое правило optimize()
+struct PeepholeStats
+{
+    size_t instructions_before = 0;
+    size_t instructions_after = 0;
+    size_t identities = 0;     // ro_1(x) -> x, x + 0 -> x
+    size_t involutions = 0;    // ro_3(ro_3(x)) -> x, f(f(x)) -> f(x) для идемпотентных f
+    size_t folded = 0;         // операции над константами и параметрами
+    size_t merged = 0;         // повторные подвыражения
+    size_t dead = 0;           // инструкции, не влияющие на выходы
+};
+
+
+/**
+ * @brief Сеть, скомпилированная в линейную программу
+ *
+ * Каждая дуга i -> j интерпретатора NetOper - это z[j] = xi(z[j], ro(z[i])),
+ * а z[i] к моменту обработки строки i уже окончателен. Поэтому сеть
+ * записывается как последовательность инструкций над значениями:
+ * сначала константы (начальные значения узлов и параметры), затем входы,
+ * затем результаты инструкций по порядку. Параметры входят в программу
+ * константами, так что после setCs() сеть нужно скомпилировать заново.
+ *
+ * optimize() - алгебраические упрощения, точные для функций baseFunctions:
+ * тождественные дуги, двойное отрицание, повтор идемпотентных функций,
+ * сложение с нулём, свёртка констант, общие подвыражения (для коммутативных
+ * xi - с упорядочиванием операндов) и удаление мёртвых инструкций. Умножение
+ * на 1 и max/min с начальными ±Infinity не убираются: xi_2 насыщает результат,
+ * а Infinity конечна. Результат совпадает с интерпретатором с точностью
+ * до знака нуля (0 + x при x = -0)
+ */
+class CompiledNetOper
+{
+public:
+    struct Instruction
+    {
+        uint8_t binary;   // 0 - ro_op(a), 1 - xi_op(a, b)
+        uint8_t op;
+        int32_t a;
+        int32_t b;
+    };
+
+    CompiledNetOper() = default;
+
+    /**
+     * @brief Дословный перевод сети: по две инструкции на дугу
+     * @throws std::invalid_argument при неизвестной операции или узле вне матрицы
+     */
+    explicit CompiledNetOper(const NetOper& net);
+
+    /**
+     * @brief То же, что конструктор, но на месте: буферы программы переиспользуются
+     *
+     * Таблицы построителя (узлы, хэш-консинг констант и выражений) всё равно
+     * создаются на каждую компиляцию - это O(число дуг) выделений памяти
+     * @throws std::invalid_argument при неизвестной операции или узле вне матрицы
+     */
+    void compile(const NetOper& net);
+
+    /// Упростить программу; возвращает статистику правил
+    PeepholeStats optimize();
+
+    /// То же, что NetOper::calcResult: numInputs() входов, numOutputs() выходов
+    void calcResult(const float* x_in, float* y_out);
+
+    size_t size() const { return m_code.size(); }
+    size_t numInputs() const { return m_numInputs; }
+    size_t numOutputs() const { return m_outputs.size(); }
+
+    const std::vector<Instruction>& code() const { return m_code; }
+    const std::vector<float>& constants() const { return m_constants; }
+    const std::vector<int>& outputs() const { return m_outputs; }
+
+private:
+    friend class NetProgramBuilder;
+
+    std::vector<float> m_constants;   // значения [0, C)
+    size_t m_numInputs = 0;           // значения [C, C + I)
+    std::vector<Instruction> m_code;  // инструкция k пишет значение C + I + k
+    std::vector<int> m_outputs;
+    std::vector<float> m_values;      // рабочий буфер, константы уже на месте
+};
+
+
+/**
+ * @brief Сравнить программу с интерпретатором NetOper
+ *
+ * Входы - samples точек из [-range, range] (счётный генератор, воспроизводимо).
+ * Выходы должны совпадать точно; NaN считается равным NaN
+ *
+ * @return true, если все выходы совпали
+ */
+bool verifyCompiled(NetOper& net, CompiledNetOper& program, int samples = 256, float range = 10.0f, uint64_t seed = 1);
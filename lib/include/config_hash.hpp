@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Накопительный 64-битный хэш FNV-1a для конфигураций
+ * 
+ * Используется, чтобы понять, посчитаны ли сохранённые данные
+ * (чекпоинт, фитнес в архиве) при той же конфигурации
+ */
+class ConfigHash
+{
+public:
+    ConfigHash& addBytes(const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            m_value ^= bytes[i];
+            m_value *= 1099511628211ull;
+        }
+        return *this;
+    }
+
+    template <typename T>
+    ConfigHash& add(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "ConfigHash::add expects a trivially copyable type");
+        return addBytes(&value, sizeof(T));
+    }
+
+    template <typename T>
+    ConfigHash& add(const std::vector<T>& values)
+    {
+        add(static_cast<uint64_t>(values.size()));
+        for (const auto& value : values)
+            add(value);
+        return *this;
+    }
+
+    ConfigHash& add(const std::string& value)
+    {
+        add(static_cast<uint64_t>(value.size()));
+        return addBytes(value.data(), value.size());
+    }
+
+    uint64_t value() const { return m_value; }
+
+private:
+    uint64_t m_value = 14695981039346656037ull;
+};
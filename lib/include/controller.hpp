@@ -1,8 +1,10 @@
 #pragma once
 
+#include "compiled_nop.hpp"
 #include "model.hpp"
 #include "nop.hpp"
 
+#include <array>
 #include <cmath>
 #include <iostream>
 #include <map>
@@ -13,18 +15,42 @@
 class Controller 
 {
 public:
+  /// @throws std::invalid_argument если у заданной сети больше 3 входов или не 2 выхода (пустая сеть допускается)
   Controller(const Model::State &goalState, NetOper &netOper);
-  /// RP from pascal version
+  /**
+   * @brief RP from pascal version
+   * @throws std::invalid_argument если у сети, изменённой через netOper(), больше 3 входов или не 2 выхода
+   */
   virtual Model::Control calcControl(const Model::State &currState);
   /// set new goal state
   void setGoal(Model::State newGoal);
+  const Model::State& goal() const;
+  /// Выходы сети в последнем calcControl до ограничения Umax (могут быть NaN и ±Infinity)
+  const Model::Control& rawControl() const;
 
+  /// Доступ на запись: скомпилированная программа сбрасывается, calcControl идёт через интерпретатор
   NetOper& netOper();
+
+  /**
+   * @brief Заменить сеть и скомпилировать её с оптимизацией (CompiledNetOper)
+   *
+   * Если сеть совпадает с уже скомпилированной (матрица, параметры, узлы),
+   * ничего не делает. Иначе данные сети копируются в буферы контроллера и
+   * программа собирается на месте; остаётся стоимость компиляции - таблицы
+   * построителя программы, O(число дуг) на вызов, что мало по сравнению с симуляцией.
+   * Отклонённая сеть ничего не меняет: контроллер продолжает работать с прежней
+   * @throws std::invalid_argument если у сети больше 3 входов или не 2 выхода, или она не компилируется
+   *         (неизвестная операция и т.п.)
+   */
+  void setNetOper(const NetOper& netOper);
   
   void setUMax(float newUMax);
 
 protected:
   Model::State m_goal;
   NetOper m_netOper;
+  CompiledNetOper m_program;
+  bool m_compiled = false;
+  Model::Control m_rawControl{0.0f, 0.0f};
   float Umax = 1.0f; // was 0.4 - OK
 };
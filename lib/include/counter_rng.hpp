@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+/// Назначение потока случайных чисел: разные назначения не пересекаются
+enum class RngPurpose : uint32_t
+{
+    Initialization = 1,
+    Selection = 2,
+    Crossover = 3,
+    Mutation = 4,
+    StructVariation = 5,
+    Replacement = 6,
+    Fingerprint = 7,
+    Verification = 8
+};
+
+/**
+ * @brief Счётный генератор Philox4x32-10
+ *
+ * Число - функция от (seed, поколение, номер потомка, назначение, номер выборки),
+ * состояния нет. Поэтому результат не зависит от того, в каком потоке и в каком
+ * порядке берутся числа, а для продолжения с чекпоинта достаточно номера поколения.
+ * Удовлетворяет UniformRandomBitGenerator; для переносимости между стандартными
+ * библиотеками лучше uniformInt()/uniformReal(), а не std::*_distribution
+ */
+class CounterRng
+{
+public:
+    using result_type = uint32_t;
+
+    CounterRng(uint64_t seed, uint32_t generation, uint32_t index, RngPurpose purpose)
+        : m_key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          m_counter{0, index, generation, static_cast<uint32_t>(purpose)}
+    {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        if (m_used == 4) {
+            philox(m_counter, m_key, m_block);
+            ++m_counter[0];
+            m_used = 0;
+        }
+        return m_block[m_used++];
+    }
+
+    /// Целое из [0, n), n > 0
+    int uniformInt(int n)
+    {
+        return static_cast<int>((static_cast<uint64_t>((*this)()) * static_cast<uint32_t>(n)) >> 32);
+    }
+
+    /// Вещественное из [0, 1)
+    float uniformReal()
+    {
+        return static_cast<float>((*this)() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    /// Один блок Philox4x32-10: out = f(counter, key)
+    static void philox(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+    {
+        uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+            const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+            const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<uint32_t>(p1);
+            c3 = static_cast<uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+private:
+    uint32_t m_key[2];
+    uint32_t m_counter[4];
+    uint32_t m_block[4] = {0, 0, 0, 0};
+    int m_used = 4;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+
+/// Сборка под x86 компилятором GCC/Clang: ядра под разные наборы команд
+/// собираются в одном бинарнике через __attribute__((target)), выбор - при запуске
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NOP_CPU_DISPATCH 1
+#else
+#define NOP_CPU_DISPATCH 0
+#endif
+
+/// Наборы векторных команд по возрастанию: каждый следующий включает предыдущие
+enum class CpuIsa : int
+{
+    Scalar = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+    AVX512 = 3
+};
+
+/// Лучший набор команд, который поддерживают процессор и ОС (CPUID)
+CpuIsa detectCpuIsa();
+
+/**
+ * @brief Набор команд для векторных ядер
+ *
+ * При первом вызове - detectCpuIsa(), если не задана переменная окружения
+ * NOP_ISA=scalar|sse2|avx2|avx512 (для сравнения ядер в бенчмарках).
+ * Набор выше поддерживаемого понижается до detectCpuIsa() с предупреждением
+ */
+CpuIsa activeCpuIsa();
+
+/// Задать набор команд из программы (тесты); возвращает установленный после понижения
+CpuIsa setActiveCpuIsa(CpuIsa isa);
+
+const char* cpuIsaName(CpuIsa isa);
+
+/// Разобрать имя набора (как в NOP_ISA, без учёта регистра); false - неизвестное имя
+bool parseCpuIsa(const std::string& name, CpuIsa& isa);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ifitness_evaluator.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct FingerprintConfig
+{
+    /// Число пробных входов; 0 - кэш выключен, всё уходит во внутренний evaluator
+    int num_probes = 64;
+
+    /// Входы выбираются равномерно из [-probe_range, probe_range] (одни и те же для всех сетей)
+    float probe_range = 1.0f;
+
+    /// Шаг квантования выходов: сети, отличающиеся меньше, считаются одинаковыми
+    float quantum = 1e-4f;
+
+    /// Сравнивать квантованные выходы целиком, а не только хэш (защита от коллизий хэша)
+    bool verify = true;
+
+    /// Предел числа отпечатков; при переполнении кэш очищается
+    size_t max_entries = 1u << 20;
+};
+
+struct FingerprintStats
+{
+    long hits = 0;        // фитнес взят из кэша или у повтора в том же пакете
+    long misses = 0;      // сеть отправлена внутреннему evaluator'у (hits + misses = число оценок)
+    long collisions = 0;  // хэш совпал, выходы - нет (оценена заново)
+};
+
+
+/**
+ * @brief Кэш фитнеса по поведенческому отпечатку сети
+ *
+ * Перед симуляцией сеть вычисляется на фиксированном наборе пробных входов,
+ * квантованные выходы хэшируются. Сети с тем же отпечатком (мёртвые дуги,
+ * цепочки тождественных операций, разные матрицы одной функции) получают
+ * уже посчитанный фитнес без повторной симуляции. Отпечаток совпадает лишь
+ * на пробных точках, поэтому их число и диапазон задаются конфигурацией.
+ * Потокобезопасен; внутренний evaluator вызывается вне блокировки
+ */
+class FingerprintEvaluator : public IFitnessEvaluator
+{
+public:
+    FingerprintEvaluator(std::shared_ptr<IFitnessEvaluator> inner, const FingerprintConfig& config = FingerprintConfig());
+
+    std::vector<float> evaluate(const ISolution& solution) override;
+    std::vector<std::vector<float>> evaluateBatch(const std::vector<const ISolution*>& solutions) override;
+
+    int getNumObjectives() const override { return m_inner->getNumObjectives(); }
+    uint64_t getConfigHash() const override { return m_inner->getConfigHash(); }
+
+    FingerprintStats stats() const;
+
+    /// Квантованные выходы сети на пробных входах
+    std::vector<int64_t> probe(const NetOper& net) const;
+
+    static uint64_t hash(const std::vector<int64_t>& outputs);
+
+private:
+    struct Entry
+    {
+        std::vector<int64_t> outputs;
+        std::vector<float> fitness;
+    };
+
+    bool lookup(uint64_t key, const std::vector<int64_t>& outputs, std::vector<float>& fitness);
+    void store(uint64_t key, std::vector<int64_t> outputs, const std::vector<float>& fitness);
+
+    std::shared_ptr<IFitnessEvaluator> m_inner;
+    FingerprintConfig m_config;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, Entry> m_cache;
+    FingerprintStats m_stats;
+};
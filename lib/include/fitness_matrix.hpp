@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+/// Аллокатор с выравниванием Align байт (для векторных загрузок)
+template <typename T, size_t Align>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t n)
+    {
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, Align, n * sizeof(T)) != 0) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t) { std::free(ptr); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+
+/**
+ * @brief Фитнес популяции одним выровненным блоком M x N (по критериям)
+ *
+ * Значения критерия j для всех особей лежат подряд (column(j)), строка
+ * дополнена NaN до кратного Lanes: NaN никого не доминирует, поэтому ядра
+ * доминирования обрабатывают хвост целым векторным блоком. Ядро (скалярное,
+ * SSE2, AVX2 или AVX-512) выбирается при запуске по activeCpuIsa()
+ */
+class FitnessMatrix
+{
+public:
+    /// Ширина блока (особей) и выравнивание (байт)
+    static constexpr size_t Lanes = 16;
+    static constexpr size_t Alignment = 64;
+
+    FitnessMatrix() = default;
+    FitnessMatrix(size_t size, size_t num_objectives) { resize(size, num_objectives); }
+
+    /// Изменить размер; все значения сбрасываются в 0
+    void resize(size_t size, size_t num_objectives);
+
+    size_t size() const { return m_size; }
+    size_t numObjectives() const { return m_numObjectives; }
+    size_t stride() const { return m_stride; }
+
+    float at(size_t individual, size_t objective) const { return m_data[objective * m_stride + individual]; }
+    void set(size_t individual, size_t objective, float value) { m_data[objective * m_stride + individual] = value; }
+
+    std::vector<float> row(size_t individual) const;
+    void setRow(size_t individual, const float* fitness);
+    void setRow(size_t individual, const std::vector<float>& fitness) { setRow(individual, fitness.data()); }
+
+    /// Значения критерия objective для всех особей (stride() элементов, выровнено)
+    const float* column(size_t objective) const { return m_data.data() + objective * m_stride; }
+
+    /// Популяция построчно (для совместимости с vector<vector<float>>)
+    std::vector<std::vector<float>> rows() const;
+
+    /**
+     * @brief Число особей, доминирующих candidate (numObjectives() значений)
+     *
+     * Особь i доминирует candidate, если не хуже по всем критериям
+     * и строго лучше хотя бы по одному (минимизация)
+     */
+    int countDominating(const float* candidate) const;
+
+    /// Ранги всей популяции: ranks[i] = countDominating(row(i))
+    void dominationCounts(std::vector<int>& ranks) const;
+
+private:
+    size_t m_size = 0;
+    size_t m_numObjectives = 0;
+    size_t m_stride = 0;
+    std::vector<float, AlignedAllocator<float, Alignment>> m_data;
+};
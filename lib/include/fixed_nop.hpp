@@ -0,0 +1,212 @@
+#pragma once
+
+#include "baseFunctions.hpp"
+#include "nop.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Операции сети над значениями типа Scalar
+ *
+ * По умолчанию значение приводится к float и вычисляется функциями baseFunctions
+ * (для float приведения пустые). Другое представление чисел специализирует шаблон
+ */
+template <typename Scalar>
+struct NetScalarOps
+{
+    static Scalar fromFloat(float value) { return static_cast<Scalar>(value); }
+    static float toFloat(Scalar value) { return static_cast<float>(value); }
+
+    static Scalar unary(int op, Scalar x)
+    {
+        return static_cast<Scalar>(UnaryFunctions[op](static_cast<float>(x)));
+    }
+
+    static Scalar binary(int op, Scalar l, Scalar r)
+    {
+        return static_cast<Scalar>(BinaryFunctions[op](static_cast<float>(l), static_cast<float>(r)));
+    }
+};
+
+
+/**
+ * @brief Сетевой оператор с размерами, известными при компиляции
+ *
+ * L узлов, NIn входов, NParams параметров, NOut выходов. Всё хранится в std::array,
+ * рабочий вектор z - локальный массив calcResult(), поэтому вычисление const,
+ * без выделения памяти и безопасно из нескольких потоков. Дуги матрицы заранее
+ * собраны в список в порядке обхода NetOper::calcResult (по строкам), результат
+ * для Scalar = float совпадает с NetOper бит в бит.
+ *
+ * Преобразуется в NetOper и обратно; неверные размеры дают std::invalid_argument
+ */
+template <size_t L, size_t NIn, size_t NParams, size_t NOut, typename Scalar = float>
+class FixedNetOper
+{
+    static_assert(L > 0 && L <= 256, "FixedNetOper: node indices are stored as uint8_t");
+    static_assert(NIn <= L && NParams <= L && NOut > 0, "FixedNetOper: inconsistent dimensions");
+
+public:
+    using Ops = NetScalarOps<Scalar>;
+
+    static constexpr size_t MaxArcs = L * (L - 1) / 2;
+
+    FixedNetOper() = default;
+
+    /**
+     * @brief Скопировать сеть из NetOper
+     * @throws std::invalid_argument если размеры не совпадают с параметрами шаблона
+     *         или в матрице неизвестная операция
+     */
+    explicit FixedNetOper(NetOper& net)
+    {
+        const auto& psi = net.getPsi();
+        const auto& vars = net.getNodesForVars();
+        const auto& params = net.getNodesForParams();
+        const auto& outputs = net.getNodesForOutput();
+        const auto& cs = net.getCs();
+
+        if (psi.size() != L) {
+            throw std::invalid_argument("FixedNetOper: matrix size " + std::to_string(psi.size()) +
+                                        " != " + std::to_string(L));
+        }
+        for (const auto& row : psi) {
+            if (row.size() != L) {
+                throw std::invalid_argument("FixedNetOper: matrix must be square");
+            }
+        }
+        if (vars.size() != NIn || params.size() != NParams || outputs.size() != NOut) {
+            throw std::invalid_argument("FixedNetOper: node counts do not match template dimensions");
+        }
+        if (cs.size() < NParams) {
+            throw std::invalid_argument("FixedNetOper: fewer parameters than parameter nodes");
+        }
+
+        copyNodes(vars, m_vars);
+        copyNodes(params, m_paramNodes);
+        copyNodes(outputs, m_outputs);
+        for (size_t k = 0; k < NParams; ++k) {
+            m_params[k] = Ops::fromFloat(cs[k]);
+        }
+
+        for (size_t i = 0; i < L; ++i) {
+            const int op = psi[i][i];
+            if (op < 0 || op > 255) {
+                throw std::invalid_argument("FixedNetOper: node operation " + std::to_string(op) + " out of range");
+            }
+            m_nodeOps[i] = static_cast<uint8_t>(op);
+            m_init[i] = Ops::fromFloat(op == 2 ? 1.0f : op == 3 ? -Infinity : op == 4 ? Infinity : 0.0f);
+        }
+
+        m_numArcs = 0;
+        for (size_t i = 0; i + 1 < L; ++i) {
+            for (size_t j = i + 1; j < L; ++j) {
+                const int op = psi[i][j];
+                if (op == 0) {
+                    continue;
+                }
+                if (op < 1 || op > NumUnaryFunctions) {
+                    throw std::invalid_argument("FixedNetOper: unknown unary operation " + std::to_string(op));
+                }
+                if (m_nodeOps[j] < 1 || m_nodeOps[j] > NumBinaryFunctions) {
+                    throw std::invalid_argument("FixedNetOper: unknown binary operation " + std::to_string(m_nodeOps[j]));
+                }
+                m_arcs[m_numArcs++] = {static_cast<uint8_t>(i), static_cast<uint8_t>(j), static_cast<uint8_t>(op)};
+            }
+        }
+    }
+
+    /// Обратное преобразование (параметры через Ops::toFloat); элементы матрицы ниже
+    /// диагонали и параметры сверх NParams не вычисляются и потому не сохраняются
+    NetOper toNetOper() const
+    {
+        std::vector<std::vector<int>> psi(L, std::vector<int>(L, 0));
+        for (size_t i = 0; i < L; ++i) {
+            psi[i][i] = m_nodeOps[i];
+        }
+        for (size_t a = 0; a < m_numArcs; ++a) {
+            psi[m_arcs[a].from][m_arcs[a].to] = m_arcs[a].op;
+        }
+
+        std::vector<float> cs(NParams);
+        for (size_t k = 0; k < NParams; ++k) {
+            cs[k] = Ops::toFloat(m_params[k]);
+        }
+
+        NetOper net;
+        net.setNodesForVars(std::vector<int>(m_vars.begin(), m_vars.end()));
+        net.setNodesForParams(std::vector<int>(m_paramNodes.begin(), m_paramNodes.end()));
+        net.setNodesForOutput(std::vector<int>(m_outputs.begin(), m_outputs.end()));
+        net.setCs(cs);
+        net.setPsi(psi);
+        return net;
+    }
+
+    /// Как NetOper::calcResult: NIn входов, NOut выходов
+    void calcResult(const Scalar* x_in, Scalar* y_out) const
+    {
+        std::array<Scalar, L> z = m_init;
+        for (size_t k = 0; k < NIn; ++k) {
+            z[m_vars[k]] = x_in[k];
+        }
+        for (size_t k = 0; k < NParams; ++k) {
+            z[m_paramNodes[k]] = m_params[k];
+        }
+        for (size_t a = 0; a < m_numArcs; ++a) {
+            const Arc& arc = m_arcs[a];
+            z[arc.to] = Ops::binary(m_nodeOps[arc.to], z[arc.to], Ops::unary(arc.op, z[arc.from]));
+        }
+        for (size_t k = 0; k < NOut; ++k) {
+            y_out[k] = z[m_outputs[k]];
+        }
+    }
+
+    std::array<Scalar, NOut> calcResult(const std::array<Scalar, NIn>& x_in) const
+    {
+        std::array<Scalar, NOut> y_out;
+        calcResult(x_in.data(), y_out.data());
+        return y_out;
+    }
+
+    size_t numArcs() const { return m_numArcs; }
+
+    const std::array<Scalar, NParams>& params() const { return m_params; }
+    void setParams(const std::array<Scalar, NParams>& params) { m_params = params; }
+
+private:
+    struct Arc
+    {
+        uint8_t from;
+        uint8_t to;
+        uint8_t op;
+    };
+
+    template <size_t N>
+    static void copyNodes(const std::vector<int>& nodes, std::array<uint8_t, N>& out)
+    {
+        for (size_t k = 0; k < N; ++k) {
+            if (nodes[k] < 0 || static_cast<size_t>(nodes[k]) >= L) {
+                throw std::invalid_argument("FixedNetOper: node " + std::to_string(nodes[k]) + " is outside the matrix");
+            }
+            out[k] = static_cast<uint8_t>(nodes[k]);
+        }
+    }
+
+    std::array<Arc, MaxArcs> m_arcs{};
+    size_t m_numArcs = 0;
+    std::array<uint8_t, L> m_nodeOps{};    // диагональ: бинарная операция узла
+    std::array<Scalar, L> m_init{};        // начальные значения узлов
+    std::array<uint8_t, NIn> m_vars{};
+    std::array<uint8_t, NParams> m_paramNodes{};
+    std::array<Scalar, NParams> m_params{};
+    std::array<uint8_t, NOut> m_outputs{};
+};
+
+
+/// Размеры сети робота (RobotProblemConfig): 24 узла, 3 входа, 8 параметров, 2 выхода
+using RobotNetOper = FixedNetOper<24, 3, 8, 2>;
@@ -0,0 +1,377 @@
+#pragma once
+
+#include "baseFunctions.hpp"
+#include "fixed_nop.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Число с фиксированной точкой Q(31-F).F в int32
+ *
+ * Все операции насыщаются до [-Max, Max] (диапазон симметричен, поэтому
+ * смена знака не переполняется). Infinity из baseFunctions в Q-формат
+ * не помещается и превращается в ±Max
+ */
+template <int F>
+struct Fixed
+{
+    static_assert(F >= 8 && F <= 24, "Fixed: fraction bits must be in [8, 24]");
+
+    static constexpr int FracBits = F;
+    static constexpr int64_t One = int64_t(1) << F;
+    static constexpr int64_t Max = std::numeric_limits<int32_t>::max();
+
+    int32_t raw = 0;
+
+    static int64_t saturate(int64_t value)
+    {
+        return value > Max ? Max : value < -Max ? -Max : value;
+    }
+
+    static Fixed fromRaw(int64_t value)
+    {
+        Fixed result;
+        result.raw = static_cast<int32_t>(saturate(value));
+        return result;
+    }
+
+    /// NaN -> 0, вне диапазона -> ±Max
+    static Fixed fromFloat(float value)
+    {
+        if (std::isnan(value)) {
+            return Fixed();
+        }
+        const double scaled = std::round(static_cast<double>(value) * One);
+        return fromRaw(scaled > Max ? Max : scaled < -Max ? -Max : static_cast<int64_t>(scaled));
+    }
+
+    float toFloat() const { return static_cast<float>(static_cast<double>(raw) / One); }
+
+    /// Наибольшее представимое значение
+    static float maxValue() { return static_cast<float>(static_cast<double>(Max) / One); }
+
+    bool operator==(const Fixed& other) const { return raw == other.raw; }
+    bool operator!=(const Fixed& other) const { return raw != other.raw; }
+};
+
+template <int F> constexpr int Fixed<F>::FracBits;
+template <int F> constexpr int64_t Fixed<F>::One;
+template <int F> constexpr int64_t Fixed<F>::Max;
+
+
+/**
+ * @brief Операции сети в фиксированной точке без вычислений с плавающей точкой
+ *
+ * Арифметика целочисленная с насыщением. Трансцендентные функции - таблицы
+ * с шагом 2^-8 и линейной интерполяцией после сведения аргумента:
+ * exp через 2^n * 2^f (f в [0, 1)), log через старший бит и мантиссу в [1, 2),
+ * sin/cos по модулю 2π, atan на [0, 1] и π/2 - atan(1/x), tanh(x/2) на [0, 32].
+ * Корни - целочисленный sqrt, кубический корень - exp2(log2(x)/3).
+ * Таблицы строятся один раз при первом обращении (на целевой платформе их
+ * можно сохранить константами)
+ */
+template <int F>
+class FixedMath
+{
+public:
+    using Value = Fixed<F>;
+
+    static constexpr int64_t One = Value::One;
+    static constexpr int64_t Max = Value::Max;
+
+    static Value unary(int op, Value x) { return Value::fromRaw(unaryRaw(op, x.raw)); }
+    static Value binary(int op, Value l, Value r) { return Value::fromRaw(binaryRaw(op, l.raw, r.raw)); }
+
+    static int64_t mul(int64_t a, int64_t b)
+    {
+        return Value::saturate((a * b + (One >> 1)) >> F);
+    }
+
+    static int64_t div(int64_t a, int64_t b)
+    {
+        return Value::saturate((a * One) / b);
+    }
+
+    /// sqrt(a), a >= 0
+    static int64_t sqrt(int64_t a)
+    {
+        return static_cast<int64_t>(isqrt(static_cast<uint64_t>(a) << F));
+    }
+
+    static int64_t exp(int64_t x)
+    {
+        return exp2((x * Log2E + (int64_t(1) << 29)) >> 30);
+    }
+
+    /// log(x), x > 0
+    static int64_t log(int64_t x)
+    {
+        return (log2(x) * Ln2 + (int64_t(1) << 29)) >> 30;
+    }
+
+    static int64_t sin(int64_t x) { return tables().sin(reduceAngle(x)); }
+    static int64_t cos(int64_t x) { return tables().sin(reduceAngle(x + tables().half_pi)); }
+
+    static int64_t atan(int64_t x)
+    {
+        const int64_t ax = std::llabs(x);
+        const int64_t t = ax <= One ? tables().atan(ax) : tables().half_pi - tables().atan(div(One, ax));
+        return x < 0 ? -t : t;
+    }
+
+private:
+    static constexpr int64_t Log2E = 1549082005;   // log2(e) в Q30
+    static constexpr int64_t Ln2 = 744261118;      // ln(2) в Q30
+
+    /// Таблица на равномерной сетке с шагом 2^shift (в raw), за концами - крайние значения
+    struct Table
+    {
+        int64_t origin = 0;
+        int shift = 0;
+        std::vector<int32_t> values;
+
+        template <typename Function>
+        void build(double from, double to, Function function)
+        {
+            shift = F - 8;
+            origin = static_cast<int64_t>(std::llround(from * One));
+            const size_t intervals = static_cast<size_t>(std::ceil((to - from) * 256.0));
+            values.resize(intervals + 1);
+            for (size_t i = 0; i <= intervals; ++i) {
+                const double x = static_cast<double>(origin + (static_cast<int64_t>(i) << shift)) / One;
+                values[i] = static_cast<int32_t>(Value::saturate(std::llround(function(x) * One)));
+            }
+        }
+
+        int64_t operator()(int64_t x) const
+        {
+            const int64_t d = x - origin;
+            if (d <= 0) {
+                return values.front();
+            }
+            const size_t index = static_cast<size_t>(d >> shift);
+            if (index + 1 >= values.size()) {
+                return values.back();
+            }
+            const int64_t frac = d & ((int64_t(1) << shift) - 1);
+            const int64_t step = static_cast<int64_t>(values[index + 1]) - values[index];
+            return values[index] + ((step * frac) >> shift);
+        }
+    };
+
+    struct Tables
+    {
+        Table exp2;        // 2^f, f в [0, 1]
+        Table log2;        // log2(m), m в [1, 2]
+        Table sin;         // [0, 2π]
+        Table atan;        // [0, 1]
+        Table tanh_half;   // tanh(x / 2), [0, 32]
+        int64_t two_pi_wide;   // 2π в Q(F + 16) для сведения аргумента
+        int64_t half_pi;
+
+        Tables()
+        {
+            const double pi = std::acos(-1.0);
+            exp2.build(0.0, 1.0, [](double x) { return std::exp2(x); });
+            log2.build(1.0, 2.0, [](double x) { return std::log2(x); });
+            sin.build(0.0, 2.0 * pi, [](double x) { return std::sin(x); });
+            atan.build(0.0, 1.0, [](double x) { return std::atan(x); });
+            tanh_half.build(0.0, 32.0, [](double x) { return std::tanh(x / 2.0); });
+            two_pi_wide = static_cast<int64_t>(std::llround(2.0 * pi * One * 65536.0));
+            half_pi = static_cast<int64_t>(std::llround(pi / 2.0 * One));
+        }
+    };
+
+    static const Tables& tables()
+    {
+        static const Tables instance;
+        return instance;
+    }
+
+    static uint64_t isqrt(uint64_t value)
+    {
+        uint64_t result = 0;
+        uint64_t bit = uint64_t(1) << 62;
+        while (bit > value) {
+            bit >>= 2;
+        }
+        while (bit != 0) {
+            if (value >= result + bit) {
+                value -= result + bit;
+                result = (result >> 1) + bit;
+            } else {
+                result >>= 1;
+            }
+            bit >>= 2;
+        }
+        return result;
+    }
+
+    /// 2^y, y в Q F
+    static int64_t exp2(int64_t y)
+    {
+        const int64_t n = y >> F;   // floor
+        const int64_t t = tables().exp2(y & (One - 1));
+        if (n >= 0) {
+            return n > 31 ? Max : Value::saturate(t << n);
+        }
+        return -n > 62 ? 0 : (t >> -n);
+    }
+
+    /// log2(x) в Q F, x > 0
+    static int64_t log2(int64_t x)
+    {
+        int k = 0;
+        while ((x >> (k + 1)) != 0) {
+            ++k;
+        }
+        const int64_t m = k > F ? (x >> (k - F)) : (x << (F - k));
+        return (static_cast<int64_t>(k - F) << F) + tables().log2(m);
+    }
+
+    static int64_t reduceAngle(int64_t x)
+    {
+        int64_t wide = (x << 16) % tables().two_pi_wide;
+        if (wide < 0) {
+            wide += tables().two_pi_wide;
+        }
+        return wide >> 16;
+    }
+
+    static int64_t sign(int64_t x) { return x >= 0 ? 1 : -1; }
+
+    static int64_t constant(double value) { return static_cast<int64_t>(std::llround(value * One)); }
+
+    static int64_t unaryRaw(int op, int64_t v)
+    {
+        static const int64_t ln_inv_eps = constant(-std::log(static_cast<double>(Eps)));   // 18.42
+        static const int64_t cube_limit = constant(std::cbrt(static_cast<double>(Infinity)));
+        static const int64_t dead_zone = constant(0.01);
+
+        const int64_t a = std::llabs(v);
+        const int64_t s = sign(v);
+        switch (op) {
+        case 1: return v;
+        case 2: return mul(v, v);
+        case 3: return -v;
+        case 4: return s * sqrt(a);
+        case 5: return v == 0 ? Max : div(One, v);
+        case 6: return v > ln_inv_eps ? ln_inv_eps : exp(v);
+        // В ro_7 порог exp(-PokMax) с беззнаковым PokMax равен +inf: для любого конечного входа log(Eps)
+        case 7: return -ln_inv_eps;
+        case 8: return a > ln_inv_eps ? s * One : s * tables().tanh_half(a);
+        case 9: return v >= 0 ? One : 0;
+        case 10: return s * One;
+        case 11: return cos(v);
+        case 12: return sin(v);
+        case 13: return atan(v);
+        case 14: return a > cube_limit ? s * Max : mul(mul(v, v), v);
+        case 15: return v == 0 ? 0 : s * exp2(log2(a) / 3);
+        case 16: return a < One ? v : s * One;
+        case 17: return s * log(Value::saturate(a + One));
+        case 18: return a > ln_inv_eps ? s * Max : s * Value::saturate(exp(a) - One);
+        case 19: return s * exp(-a);
+        case 20: return v / 2;
+        case 21: return v * 2;
+        case 22: return v < 0 ? exp(v) - One : One - exp(-a);
+        case 23: return v - mul(mul(v, v), v);
+        case 24: return (One + s * tables().tanh_half(a)) / 2;
+        case 25: return v > 0 ? One : 0;
+        case 26: return a < dead_zone ? 0 : s * One;
+        case 27: return a > One ? s * One : s * (One - sqrt(One - mul(v, v)));
+        case 28: {
+            const int64_t square = mul(v, v);
+            return square > ln_inv_eps ? v : mul(v, One - exp(-square));
+        }
+        default: return 0;
+        }
+    }
+
+    static int64_t binaryRaw(int op, int64_t l, int64_t r)
+    {
+        const int64_t s = sign(l + r);
+        switch (op) {
+        case 1: return l + r;
+        case 2: return mul(l, r);
+        case 3: return l >= r ? l : r;
+        case 4: return l < r ? l : r;
+        case 5: return l + r - mul(l, r);
+        case 6: return s * static_cast<int64_t>(isqrt(static_cast<uint64_t>(l * l) + static_cast<uint64_t>(r * r)));
+        case 7: return s * (std::llabs(l) + std::llabs(r));
+        case 8: return s * mul(std::llabs(l), std::llabs(r));
+        default: return 0;
+        }
+    }
+};
+
+template <int F> constexpr int64_t FixedMath<F>::One;
+template <int F> constexpr int64_t FixedMath<F>::Max;
+template <int F> constexpr int64_t FixedMath<F>::Log2E;
+template <int F> constexpr int64_t FixedMath<F>::Ln2;
+
+
+/// Операции сети для FixedNetOper<..., Fixed<F>>
+template <int F>
+struct NetScalarOps<Fixed<F>>
+{
+    static Fixed<F> fromFloat(float value) { return Fixed<F>::fromFloat(value); }
+    static float toFloat(Fixed<F> value) { return value.toFloat(); }
+    static Fixed<F> unary(int op, Fixed<F> x) { return FixedMath<F>::unary(op, x); }
+    static Fixed<F> binary(int op, Fixed<F> l, Fixed<F> r) { return FixedMath<F>::binary(op, l, r); }
+};
+
+
+/// Точность сети в фиксированной точке относительно float
+struct FixedPointAccuracy
+{
+    size_t samples = 0;           // сравнённых выходов
+    size_t saturated = 0;         // выход float вне диапазона формата или не конечен (не сравнивается)
+    float max_abs_error = 0.0f;
+    float mean_abs_error = 0.0f;
+    float max_output = 0.0f;      // наибольший |выход| float - для выбора числа целых бит
+};
+
+/**
+ * @brief Сравнить fixed-вариант сети с NetOper на заданных входах
+ *
+ * Входы квантуются в формат, так что ошибка включает и квантование входов
+ */
+template <size_t L, size_t NIn, size_t NParams, size_t NOut, int F>
+FixedPointAccuracy fixedPointAccuracy(NetOper& net,
+                                      const FixedNetOper<L, NIn, NParams, NOut, Fixed<F>>& fixed,
+                                      const std::vector<std::array<float, NIn>>& inputs)
+{
+    FixedPointAccuracy report;
+    double total_error = 0.0;
+    for (const auto& x : inputs) {
+        std::array<Fixed<F>, NIn> fixed_x;
+        for (size_t k = 0; k < NIn; ++k) {
+            fixed_x[k] = Fixed<F>::fromFloat(x[k]);
+        }
+        float expected[NOut];
+        net.calcResult(x.data(), expected);
+        const auto actual = fixed.calcResult(fixed_x);
+
+        for (size_t k = 0; k < NOut; ++k) {
+            if (!std::isfinite(expected[k]) || std::fabs(expected[k]) > Fixed<F>::maxValue()) {
+                ++report.saturated;
+                continue;
+            }
+            const float error = std::fabs(actual[k].toFloat() - expected[k]);
+            report.max_abs_error = std::max(report.max_abs_error, error);
+            report.max_output = std::max(report.max_output, std::fabs(expected[k]));
+            total_error += error;
+            ++report.samples;
+        }
+    }
+    if (report.samples > 0) {
+        report.mean_abs_error = static_cast<float>(total_error / report.samples);
+    }
+    return report;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "isolution.hpp"
+#include <cstdint>
 #include <vector>
 
 class IFitnessEvaluator {
@@ -9,6 +10,20 @@ public:
     // Вычисляет вектор критериев для данного решения
     virtual std::vector<float> evaluate(const ISolution& solution) = 0;
     
+    // Пакетная оценка (удалённые/параллельные evaluator'ы переопределяют)
+    virtual std::vector<std::vector<float>> evaluateBatch(const std::vector<const ISolution*>& solutions) {
+        std::vector<std::vector<float>> results;
+        results.reserve(solutions.size());
+        for (const ISolution* solution : solutions) {
+            results.push_back(evaluate(*solution));
+        }
+        return results;
+    }
+    
     // Размерность пространства критериев
     virtual int getNumObjectives() const = 0;
+    
+    // Хэш всего, от чего зависит результат evaluate() (0 - неизвестен,
+    // сохранённый фитнес тогда не переиспользуется)
+    virtual uint64_t getConfigHash() const { return 0; }
 };
\ No newline at end of file
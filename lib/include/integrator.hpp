@@ -0,0 +1,103 @@
+#pragma once
+
+#include "model.hpp"
+#include "controller.hpp"
+
+#include <memory>
+
+/// Схема интегрирования шага симуляции
+enum class IntegrationMethod
+{
+    Euler,  // явный Эйлер, один вызов контроллера и NN (как раньше)
+    Heun,   // RK2 / метод Хойна
+    RK4,    // классический Рунге-Кутта 4 порядка
+    Arc     // точное интегрирование кинематики при постоянных (v, w) - для больших dt
+};
+
+/**
+ * @brief Интегратор одного шага Runner
+ * 
+ * Стадия шага: управление в точке стадии -> NN скорости из скоростей
+ * начала шага -> производная позы. При удержании управления (hold_control)
+ * контроллер и NN вызываются только на первой стадии, остальные стадии
+ * берут закэшированные скорости - как на реальном роботе, где управление
+ * держится постоянным весь период дискретизации
+ */
+class Integrator
+{
+public:
+    explicit Integrator(bool holdControl = true);
+    virtual ~Integrator() = default;
+
+    /// Сделать шаг длины model.getDt(): возвращает новую позу, скорости модели обновляются
+    virtual Model::State step(Model& model, Controller& controller) = 0;
+
+    /**
+     * @brief Шаг с известным управлением u0 в начальной точке (model.getState())
+     *
+     * Первая стадия берёт u0 вместо вызова контроллера - для Runner с адаптивным
+     * шагом, у которого управление в начале шага уже посчитано при проверке прошлого
+     */
+    Model::State step(Model& model, Controller& controller, const Model::Control& u0);
+
+    /// Количество стадий (вызовов контроллера и NN без удержания управления)
+    virtual int stages() const = 0;
+
+    bool holdControl() const;
+
+protected:
+    /// Начать шаг: сохранить скорости модели и сбросить кэш
+    void beginStep(Model& model);
+    /// Скорости на стадии в точке s (с учётом кэша)
+    Model::Velocity stageVelocity(Model& model, Controller& controller, const Model::State& s);
+    /// Завершить шаг: записать итоговые скорости в модель
+    void endStep(Model& model, const Model::Velocity& vel);
+
+private:
+    bool m_holdControl;
+    bool m_hasCache = false;
+    bool m_hasStartControl = false;
+    Model::Control m_startControl{0.0f, 0.0f};
+    Model::Velocity m_cachedVelocity{0.0f, 0.0f};
+    Model::Velocity m_startVelocity{0.0f, 0.0f};
+};
+
+
+class EulerIntegrator : public Integrator
+{
+public:
+    using Integrator::Integrator;
+    using Integrator::step;
+    Model::State step(Model& model, Controller& controller) override;
+    int stages() const override { return 1; }
+};
+
+class HeunIntegrator : public Integrator
+{
+public:
+    using Integrator::Integrator;
+    using Integrator::step;
+    Model::State step(Model& model, Controller& controller) override;
+    int stages() const override { return 2; }
+};
+
+class RK4Integrator : public Integrator
+{
+public:
+    using Integrator::Integrator;
+    using Integrator::step;
+    Model::State step(Model& model, Controller& controller) override;
+    int stages() const override { return 4; }
+};
+
+class ArcIntegrator : public Integrator
+{
+public:
+    ArcIntegrator() : Integrator(true) {}
+    using Integrator::step;
+    Model::State step(Model& model, Controller& controller) override;
+    int stages() const override { return 1; }
+};
+
+
+std::unique_ptr<Integrator> makeIntegrator(IntegrationMethod method, bool holdControl = true);
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "GAConfig.hpp"
+#include "GANOP.hpp"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Схема связей между островами
+enum class MigrationTopology
+{
+    Ring,            // остров i отправляет мигрантов острову i+1
+    FullyConnected,  // каждый остров отправляет мигрантов всем остальным
+    Random           // при каждой миграции - одному случайному острову
+};
+
+struct IslandConfig
+{
+    /// Количество популяций (каждая - GAConfig::population_size особей)
+    int num_islands = 4;
+
+    /// Миграция каждые N поколений
+    int migration_interval = 4;
+
+    /// Сколько лучших Парето-оптимальных особей отправляет остров за одну миграцию
+    int migrants_per_island = 2;
+
+    MigrationTopology topology = MigrationTopology::Ring;
+};
+
+
+/**
+ * @brief Островная модель GANOP
+ * 
+ * K независимых популяций эволюционируют в отдельных потоках, между
+ * миграциями потоки не синхронизируются. Каждые migration_interval поколений
+ * острова обмениваются лучшими Парето-оптимальными особями по заданной топологии.
+ * 
+ * Колбэки GAConfig вызываются для модели целиком: on_generation_end - после каждой
+ * эпохи со средним по всем островам, on_algorithm_end - для лучшей особи всех островов.
+ * Чекпоинты островов не поддерживаются, checkpoint_path игнорируется
+ */
+class IslandModel
+{
+public:
+    IslandModel(const GAConfig& config, const IslandConfig& island_config);
+
+    void run();
+
+    int numIslands() const;
+    const GANOP& island(int i) const;
+
+    /// Остров, на котором лежит лучшее решение (по последнему критерию)
+    int getBestIsland() const;
+
+private:
+    std::vector<int> migrationTargets(int source);
+    void migrate();
+    void reportGeneration(int generation) const;
+    bool saveParetoArchive(const std::string& filepath) const;
+    bool saveEliteArchive(const std::string& filepath) const;   // объединённый архив элиты островов
+
+    GAConfig config_;
+    IslandConfig island_config_;
+    std::vector<std::unique_ptr<GANOP>> islands_;
+    std::mt19937 rng_;
+};
@@ -2,6 +2,8 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <array>
+#include <string>
 #include <onnxruntime_cxx_api.h>
 
 class Model {
@@ -33,6 +35,13 @@ struct State
   const void print() const;
 };
 
+/// Линейная и угловая скорость робота
+struct Velocity
+{
+  float v;
+  float w;
+};
+
 public:
   Model(const State &state, float dt, const std::string &onnx_path);
   void setState(const State &state);
@@ -43,6 +52,14 @@ public:
   State nextStateFromControl(const Control &u);
   State nextNNStateFromControl(const Control &u);
 
+  /// Скорости, предсказанные NN для управления u из текущих m_v, m_w (модель не меняется)
+  Velocity nnVelocityFromControl(const Control &u);
+  /// Производная позы state при скоростях vel
+  static State poseRate(const State &state, const Velocity &vel);
+
+  float getDt() const;
+  void setDt(float dt);
+
   float m_v = 0.0f, m_w = 0.0f; // предыдущие скорости
 
 private:
@@ -57,4 +74,14 @@ private:
   Ort::Env m_env;
   Ort::Session m_session;
 
+  // имена входа/выхода и тензоры создаются один раз в конструкторе,
+  // чтобы шаг симуляции не выделял память
+  std::string m_inputName;
+  std::string m_outputName;
+  std::array<float, 5> m_input{};  // [v_current, w_current, v_control, w_control, dt]
+  std::array<float, 2> m_output{}; // [v_next, w_next]
+  Ort::MemoryInfo m_memInfo;
+  Ort::Value m_inputTensor;
+  Ort::Value m_outputTensor;
+
 };
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "nop.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Архив множества сетей (*.nar)
+ * 
+ * Структура файла (little-endian):
+ *   NetArchiveHeader                               - 48 байт
+ *   образы NetOper::toBinary(), выровненные на 8 байт
+ *   индекс по смещению index_offset:
+ *     NetArchiveEntry[num_networks]                - (смещение образа, размер)
+ *     float32[num_networks][num_objectives]        - сохранённый фитнес (если num_objectives > 0)
+ * 
+ * Читается через mmap, образы доступны без копирования
+ */
+struct NetArchiveHeader
+{
+    char magic[8];             // "NOPARCH\0"
+    uint32_t version;
+    uint32_t num_objectives;   // 0 - фитнес не сохранён
+    uint64_t num_networks;
+    uint64_t index_offset;
+    uint64_t config_hash;      // хэш конфигурации, при которой посчитан фитнес
+    uint64_t reserved;
+};
+
+struct NetArchiveEntry
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+static_assert(sizeof(NetArchiveHeader) == 48, "NetArchiveHeader must be 48 bytes");
+static_assert(sizeof(NetArchiveEntry) == 16, "NetArchiveEntry must be 16 bytes");
+
+
+class NetArchiveWriter
+{
+public:
+    static constexpr uint32_t Version = 1;
+
+    NetArchiveWriter() = default;
+    ~NetArchiveWriter();
+
+    NetArchiveWriter(const NetArchiveWriter&) = delete;
+    NetArchiveWriter& operator=(const NetArchiveWriter&) = delete;
+
+    /**
+     * @param num_objectives Размер сохраняемого вектора фитнеса (0 - без фитнеса)
+     * @param config_hash Хэш конфигурации оценки (см. GANOP::configHash)
+     */
+    bool open(const std::string& filepath, uint32_t num_objectives = 0, uint64_t config_hash = 0);
+
+    bool add(const NetOper& net);
+    bool add(const NetOper& net, const std::vector<float>& fitness);
+
+    /// Дописать индекс и заголовок; вызывается и из деструктора
+    bool close();
+
+    size_t size() const;
+
+private:
+    std::ofstream m_file;
+    std::vector<char> m_image;
+    std::vector<NetArchiveEntry> m_entries;
+    std::vector<float> m_fitness;
+    uint32_t m_numObjectives = 0;
+    uint64_t m_configHash = 0;
+    uint64_t m_offset = 0;
+};
+
+
+class NetArchive
+{
+public:
+    NetArchive() = default;
+    ~NetArchive();
+
+    NetArchive(const NetArchive&) = delete;
+    NetArchive& operator=(const NetArchive&) = delete;
+
+    /// Отобразить архив в память (mmap)
+    bool open(const std::string& filepath);
+    void close();
+
+    bool isOpen() const;
+    size_t size() const;
+    uint32_t numObjectives() const;
+    uint64_t configHash() const;
+
+    /// Образ i-й сети внутри отображения (без копирования)
+    const char* image(size_t i, size_t& imageSize) const;
+
+    /// Декодировать i-ю сеть
+    bool get(size_t i, NetOper& net) const;
+
+    /// Сохранённый фитнес i-й сети (numObjectives() значений) или nullptr
+    const float* fitness(size_t i) const;
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    const NetArchiveHeader* m_header = nullptr;
+    const NetArchiveEntry* m_entries = nullptr;
+    const float* m_fitness = nullptr;
+};
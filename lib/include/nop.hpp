@@ -1,7 +1,9 @@
 #pragma once
 
 #include "baseFunctions.hpp"
+#include "counter_rng.hpp"
 #include "reader.h"
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -10,6 +12,25 @@
 #include <iostream>
 
 
+constexpr uint32_t NetOperBinaryVersion = 1;
+
+/// Заголовок бинарного образа NetOper
+struct NetOperBinaryHeader
+{
+    char magic[8];            // "NOPNET\0\0"
+    uint32_t version;
+    uint32_t size;            // L - размер матрицы
+    uint32_t num_arcs;
+    uint32_t num_params;
+    uint32_t num_vars;
+    uint32_t num_param_nodes;
+    uint32_t num_outputs;
+    uint32_t checksum;        // FNV-1a всего, что после заголовка
+};
+
+static_assert(sizeof(NetOperBinaryHeader) == 40, "NetOperBinaryHeader must be 40 bytes");
+
+
 // class network operator
 class NetOper
 {
@@ -21,24 +42,32 @@ public:
     // RPCntrol
     void calcResult(const std::vector<float>& x_in, std::vector<float>& y_out);
 
+    /**
+     * @brief Вычисление без выделения памяти
+     * 
+     * Читает getNodesForVars().size() входов из x_in и пишет
+     * getNodesForOutput().size() выходов в y_out
+     */
+    void calcResult(const float* x_in, float* y_out);
+
     float getUnaryOperationResult(int operationNum, float input);
     float getBinaryOperationResult(int operationNum, float left, float right);
     
     // TODO use move semantics and rvalues
     void setNodesForVars(const std::vector<int>& nodes);
-    const std::vector<int>& getNodesForVars();
+    const std::vector<int>& getNodesForVars() const;
 
     void setNodesForParams(const std::vector<int>& nodes);
-    const std::vector<int>& getNodesForParams();
+    const std::vector<int>& getNodesForParams() const;
 
     void setNodesForOutput(const std::vector<int>& nodes);
-    const std::vector<int>& getNodesForOutput();
+    const std::vector<int>& getNodesForOutput() const;
 
     void setCs(const std::vector<float>& newParams);
-    const std::vector<float>& getCs();
+    const std::vector<float>& getCs() const;
 
     void setPsi(const std::vector<std::vector<int>>& newMatrix);
-    const std::vector<std::vector<int>>& getPsi();
+    const std::vector<std::vector<int>>& getPsi() const;
 
     NOPMatrixReader& getReader();
     
@@ -90,8 +119,52 @@ public:
      */
     bool saveParametersToFile(const std::string& filepath) const;
 
+    /**
+     * @brief Сериализовать сеть целиком в компактный бинарный образ
+     * 
+     * Формат (little-endian), версия NetOperBinaryVersion:
+     *   заголовок NetOperBinaryHeader (40 байт, с контрольной суммой FNV-1a полезной нагрузки)
+     *   uint8[L]            - диагональ (бинарные операции узлов)
+     *   uint16[num_arcs][3] - дуги (строка, столбец, унарная операция)
+     *   float32[num_params] - параметры
+     *   uint16[...]         - узлы переменных, параметров и выходов
+     * 
+     * @param out Буфер, содержимое заменяется
+     * @return true если успешно, false если матрица не квадратная или значения не влезают в формат
+     */
+    bool toBinary(std::vector<char>& out) const;
+
+    /**
+     * @brief Восстановить сеть из бинарного образа (см. toBinary)
+     * 
+     * Образу не доверяет: неизвестные операции, узлы вне матрицы, параметров меньше,
+     * чем узлов параметров, и размеры больше самого образа отклоняются
+     * 
+     * @return true если успешно, false если образ повреждён (magic, версия, размер, контрольная сумма)
+     *         или некорректен
+     */
+    bool fromBinary(const char* data, size_t size);
+
+    /**
+     * @brief Сохранить сеть (матрица, параметры, узлы) в бинарный файл одной записью
+     */
+    bool saveToBinaryFile(const std::string& filepath) const;
+
+    /**
+     * @brief Загрузить сеть из бинарного файла одним чтением
+     */
+    bool loadFromBinaryFile(const std::string& filepath);
+
 
     void GenVar(std::vector<int>& w);
+
+    /**
+     * @brief Сгенерировать вариацию, беря случайные числа из rng вместо rand()
+     *
+     * Воспроизводимо и безопасно при вызове из нескольких потоков
+     * (у каждого потока свой CounterRng)
+     */
+    void GenVar(std::vector<int>& w, CounterRng& rng);
     void Variations(const std::vector<int>& w);
 
     std::vector<float>& get_z();
@@ -103,6 +176,9 @@ private:
     void initBinaryFunctionsMap();
     bool TestSource(int j);
 
+    template <typename Random>
+    void genVar(std::vector<int>& w, Random&& random);
+
 
 private:
     NOPMatrixReader m_reader;
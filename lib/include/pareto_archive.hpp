@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Элемент архива: фитнес и хромосома особи
+struct ParetoArchiveEntry
+{
+    std::vector<float> fitness;
+    std::vector<int> params;
+    std::vector<std::vector<int>> structure;
+};
+
+
+/**
+ * @brief Неограниченный архив недоминируемых решений на ND-дереве
+ *
+ * Хранит все когда-либо найденные недоминируемые решения (минимизация всех
+ * критериев). Узлы дерева хранят покомпонентные минимум (ideal) и максимум
+ * (nadir) своих точек, что позволяет отсекать целые поддеревья:
+ *   - nadir узла не хуже кандидата    -> кандидат доминируется любой точкой узла;
+ *   - ideal узла хуже кандидата       -> ни одна точка узла его не доминирует;
+ *   - кандидат не хуже ideal узла     -> кандидат доминирует все точки узла.
+ * Вставка и проверка доминирования обходят лишь несколько ветвей вместо всего архива
+ */
+class ParetoArchive
+{
+public:
+    explicit ParetoArchive(size_t num_objectives = 0);
+    ~ParetoArchive();
+
+    ParetoArchive(ParetoArchive&&) noexcept;
+    ParetoArchive& operator=(ParetoArchive&&) noexcept;
+
+    /// Очистить архив и задать число критериев
+    void reset(size_t num_objectives);
+
+    /**
+     * @brief Предложить решение архиву
+     *
+     * Отклоняется, если фитнес не конечен или какое-то решение архива не хуже
+     * по всем критериям (в том числе равно). Иначе добавляется, а решения,
+     * которые оно доминирует, удаляются
+     * @return true, если решение добавлено
+     */
+    bool insert(const ParetoArchiveEntry& entry);
+
+    /// Есть ли в архиве решение, не худшее fitness по всем критериям
+    bool isDominated(const float* fitness) const;
+    bool isDominated(const std::vector<float>& fitness) const { return isDominated(fitness.data()); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t numObjectives() const { return m_numObjectives; }
+
+    /**
+     * @brief Текущие решения архива в порядке добавления
+     *
+     * Порядок зависит только от последовательности insert(), а не от того, какие
+     * номера освободились: архив, заново собранный вставкой entries() по порядку,
+     * дальше выдаёт те же решения в том же порядке (продолжение с чекпоинта)
+     */
+    std::vector<const ParetoArchiveEntry*> entries() const;
+
+private:
+    struct Node;
+
+    bool covered(const Node& node, const float* fitness) const;
+    void removeCovered(Node& node, const float* fitness);
+    void insertInto(Node& node, int id);
+    void split(Node& node);
+    void releaseAll(Node& node);
+    void updateBounds(Node& node) const;
+    void extendBounds(Node& node, const float* fitness) const;
+    float distanceToCenter(const Node& node, const float* fitness) const;
+    const float* point(int id) const { return m_entries[id].fitness.data(); }
+
+    size_t m_numObjectives = 0;
+    size_t m_size = 0;
+    std::unique_ptr<Node> m_root;
+    std::vector<ParetoArchiveEntry> m_entries;  // id -> решение (удалённые - в m_free)
+    std::vector<char> m_alive;
+    std::vector<int> m_free;
+    std::vector<uint64_t> m_sequence;           // id -> номер добавления
+    uint64_t m_nextSequence = 0;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Индексированная max-куча рангов популяции
+ *
+ * Вершина - особь с наибольшим рангом, при равных рангах - с меньшим индексом
+ * (тот же выбор, что у линейного поиска первого максимума). Поиск худшей особи
+ * O(1), изменение ранга одной особи O(log N), перестроение по всем рангам O(N)
+ */
+class RankHeap
+{
+public:
+    /// Перестроить кучу по рангам всей популяции
+    void assign(const std::vector<int>& ranks)
+    {
+        m_ranks = ranks;
+        const int n = static_cast<int>(m_ranks.size());
+        m_heap.resize(n);
+        m_position.resize(n);
+        for (int i = 0; i < n; ++i) {
+            m_heap[i] = i;
+            m_position[i] = i;
+        }
+        for (int i = n / 2 - 1; i >= 0; --i) {
+            siftDown(i);
+        }
+    }
+
+    /// Изменить ранг особи index
+    void update(int index, int rank)
+    {
+        const int old_rank = m_ranks[index];
+        m_ranks[index] = rank;
+        if (rank > old_rank) {
+            siftUp(m_position[index]);
+        } else if (rank < old_rank) {
+            siftDown(m_position[index]);
+        }
+    }
+
+    /// Индекс особи с наибольшим рангом
+    int top() const { return m_heap.front(); }
+    int topRank() const { return m_ranks[m_heap.front()]; }
+
+    size_t size() const { return m_heap.size(); }
+    bool empty() const { return m_heap.empty(); }
+
+private:
+    bool above(int a, int b) const
+    {
+        return m_ranks[a] > m_ranks[b] || (m_ranks[a] == m_ranks[b] && a < b);
+    }
+
+    void swapNodes(int i, int j)
+    {
+        std::swap(m_heap[i], m_heap[j]);
+        m_position[m_heap[i]] = i;
+        m_position[m_heap[j]] = j;
+    }
+
+    void siftUp(int i)
+    {
+        while (i > 0) {
+            const int parent = (i - 1) / 2;
+            if (!above(m_heap[i], m_heap[parent])) {
+                break;
+            }
+            swapNodes(i, parent);
+            i = parent;
+        }
+    }
+
+    void siftDown(int i)
+    {
+        const int n = static_cast<int>(m_heap.size());
+        for (;;) {
+            int largest = i;
+            const int left = 2 * i + 1;
+            const int right = left + 1;
+            if (left < n && above(m_heap[left], m_heap[largest])) {
+                largest = left;
+            }
+            if (right < n && above(m_heap[right], m_heap[largest])) {
+                largest = right;
+            }
+            if (largest == i) {
+                break;
+            }
+            swapNodes(i, largest);
+            i = largest;
+        }
+    }
+
+    std::vector<int> m_ranks;     // ранг по индексу особи
+    std::vector<int> m_heap;      // индексы особей в порядке кучи
+    std::vector<int> m_position;  // позиция особи в m_heap
+};
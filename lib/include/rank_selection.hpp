@@ -0,0 +1,39 @@
+#pragma once
+
+#include "counter_rng.hpp"
+
+#include <vector>
+
+/**
+ * @brief Отбор родителя по рангу за O(1) (таблица псевдонимов Уолкера)
+ *
+ * Воспроизводит распределение турнира GANOP: tournament_size равновероятных
+ * кандидатов, побеждает наименьший ранг. Вероятность того, что минимальный
+ * ранг турнира равен r:
+ *     P(r) = (N(>=r) / N)^K - (N(>r) / N)^K,
+ * где N(>=r) - число особей с рангом не меньше r; внутри ранга выбор
+ * равновероятен. Таблица строится за O(N) по рангам поколения, каждая
+ * выборка - одно целое и одно вещественное случайное число
+ */
+class RankSelector
+{
+public:
+    /// Построить таблицу по рангам популяции
+    void build(const std::vector<int>& ranks, int tournament_size);
+
+    /// Индекс выбранной особи
+    int select(CounterRng& rng) const
+    {
+        const int i = rng.uniformInt(static_cast<int>(m_probability.size()));
+        return rng.uniformReal() < m_probability[i] ? i : m_alias[i];
+    }
+
+    bool empty() const { return m_probability.empty(); }
+
+    /// Вероятности выбора каждой особи турниром из tournament_size кандидатов
+    static std::vector<double> tournamentWeights(const std::vector<int>& ranks, int tournament_size);
+
+private:
+    std::vector<float> m_probability;
+    std::vector<int> m_alias;
+};
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <string>
 #include <boost/property_tree/ptree.hpp>
 
 using boost::property_tree::ptree;
@@ -31,13 +32,30 @@ public:
 
 	void print();
 
+	// Потоковый разбор, при неудаче - через Boost.PropertyTree
 	void readMatrix(const std::string& matrixPath);
 	
 	void readParams(const std::string& paramsPath);
 
+	// Однопроходный разбор формата CONFIG/grid/cells без построения DOM,
+	// значения пишутся сразу в матрицу. false - формат не распознан
+	// или файл испорчен (отрицательные индексы и cellcount, ячейка вне матрицы)
+	bool readMatrixStreaming(const std::string& matrixPath);
+
+	bool readParamsStreaming(const std::string& paramsPath);
+
+	// Разбор через Boost.PropertyTree (прежняя реализация);
+	// ячейка вне матрицы или отрицательный cellcount - std::invalid_argument
+	void readMatrixXml(const std::string& matrixPath);
+
+	void readParamsXml(const std::string& paramsPath);
+
 
 private:
+	bool loadFile(const std::string& path);
+
 	int m_size = 0;
 	std::vector<float> m_params;
 	std::vector<std::vector<int>>  m_matrix;
+	std::string m_buffer; // содержимое файла, переиспользуется между вызовами
 };
\ No newline at end of file
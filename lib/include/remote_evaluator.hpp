@@ -0,0 +1,120 @@
+#pragma once
+
+#include "ifitness_evaluator.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Распределённая оценка фитнеса: master (GANOP) и процессы-worker'ы
+ *
+ * Адрес: "unix:/путь/к/сокету" или "tcp:хост:порт". Master слушает адрес,
+ * worker'ы подключаются к нему. Сообщения - заголовок RemoteMessageHeader
+ * и полезная нагрузка:
+ *   Hello    (worker -> master): int32 num_objectives, uint64 config_hash
+ *   Evaluate (master -> worker): uint32 count, затем count раз uint32 size + образ NetOper::toBinary()
+ *   Result   (worker -> master): uint32 count, uint32 num_objectives, float32[count][num_objectives]
+ *   Shutdown (master -> worker): без нагрузки
+ */
+struct RemoteMessageHeader
+{
+    uint32_t magic;     // "NOPW"
+    uint32_t type;      // RemoteMessageType
+    uint32_t batch_id;
+    uint32_t size;      // размер нагрузки в байтах
+};
+
+enum RemoteMessageType : uint32_t
+{
+    RemoteHello = 1,
+    RemoteEvaluate = 2,
+    RemoteResult = 3,
+    RemoteShutdown = 4
+};
+
+struct RemoteEvaluatorConfig
+{
+    /// Адрес, который слушает master
+    std::string endpoint = "unix:/tmp/nop_evaluator.sock";
+
+    /// Сколько сетей отправляется worker'у за раз
+    int batch_size = 4;
+
+    /// Время на пакет; worker, не ответивший вовремя, отключается, пакет переотправляется
+    int timeout_ms = 120000;
+};
+
+
+/**
+ * @brief Master-сторона: отправляет декодированные сети worker'ам
+ *
+ * Пакеты раздаются свободным worker'ам; при обрыве соединения или таймауте
+ * worker отключается, а его пакет возвращается в очередь. Пока не подключён
+ * ни один worker, пакеты оцениваются локальным evaluator'ом - он же задаёт
+ * число критериев и хэш конфигурации, которые должны совпасть у worker'ов
+ *
+ * Вызов арендует свободных worker'ов из общего пула и делит пакет между ними
+ * (batch_size - верхняя граница пакета одному worker'у); блокировка держится
+ * только на время аренды и возврата, поэтому одновременные вызовы evaluate()
+ * (асинхронный GANOP) обслуживаются разными worker'ами параллельно
+ */
+class RemoteFitnessEvaluator : public IFitnessEvaluator
+{
+public:
+    RemoteFitnessEvaluator(const RemoteEvaluatorConfig& config, std::shared_ptr<IFitnessEvaluator> local);
+    ~RemoteFitnessEvaluator() override;
+
+    RemoteFitnessEvaluator(const RemoteFitnessEvaluator&) = delete;
+    RemoteFitnessEvaluator& operator=(const RemoteFitnessEvaluator&) = delete;
+
+    std::vector<float> evaluate(const ISolution& solution) override;
+    std::vector<std::vector<float>> evaluateBatch(const std::vector<const ISolution*>& solutions) override;
+
+    int getNumObjectives() const override;
+    uint64_t getConfigHash() const override;
+
+    /// Число подключённых worker'ов (обновляется во время оценки)
+    int numWorkers() const;
+
+private:
+    /// Worker, арендованный одним вызовом evaluateBatch
+    struct Worker
+    {
+        int fd = -1;
+        bool busy = false;
+        uint32_t batch_id = 0;
+        size_t chunk = 0;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    /// Принять одно подключение (под m_mutex); false - новых нет
+    bool acceptWorker();
+    void dropWorker(Worker& worker, std::deque<size_t>& pending);
+
+    RemoteEvaluatorConfig m_config;
+    std::shared_ptr<IFitnessEvaluator> m_local;
+    int m_listenFd = -1;
+    std::string m_unixPath;
+
+    std::mutex m_mutex;
+    std::condition_variable m_workerReturned;
+    std::vector<int> m_idle;              // сокеты свободных worker'ов (под m_mutex)
+    std::atomic<int> m_numWorkers{0};     // свободные и арендованные
+    std::atomic<uint32_t> m_nextBatchId{1};
+};
+
+
+/**
+ * @brief Worker-сторона: подключиться к master и оценивать присланные сети
+ *
+ * Возвращается после команды Shutdown или обрыва соединения
+ * @return Количество оценённых сетей или -1, если подключиться не удалось
+ */
+long runEvaluationWorker(const std::string& endpoint, IFitnessEvaluator& evaluator);
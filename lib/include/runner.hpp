@@ -2,6 +2,97 @@
 // #include <onnxruntime_cxx_api.h>
 #include "model.hpp"
 #include "controller.hpp"
+#include "integrator.hpp"
+
+#include <memory>
+
+/**
+ * @brief Настройки адаптивного шага
+ * 
+ * Шаг всегда кратен базовому dt модели (периоду дискретизации контроллера)
+ * и лежит в [dt, max_step_multiple * dt]. Шаг растёт, пока управление
+ * между началом и концом шага меняется слабо и робот почти не поворачивает,
+ * и уменьшается у цели и на резких поворотах
+ */
+struct AdaptiveStepping
+{
+    bool enabled = false;
+    /// Максимальный шаг в единицах базового dt
+    int max_step_multiple = 4;
+    /// Допустимое изменение управления за шаг (по каждому колесу)
+    float control_tolerance = 0.05f;
+    /// Допустимый поворот за шаг, рад
+    float max_turn = 0.1f;
+    /// Внутри этого радиуса от цели шаг линейно уменьшается до базового
+    float slow_radius = 1.0f;
+};
+
+/**
+ * @brief Условия досрочного прерывания расходящейся траектории
+ * 
+ * Траектория прерывается, если состояние или выход сети не конечны (NaN, inf),
+ * или все выходы сети saturation_steps шагов подряд по модулю не меньше
+ * saturation_level с неизменными знаками (сеть ушла в ±Infinity и робот
+ * едет по прямой или крутится на месте с ограниченным Umax управлением)
+ */
+struct DivergenceGuard
+{
+    bool enabled = true;
+    /// Порог насыщения выхода сети (Infinity - значение насыщения функций сети)
+    float saturation_level = Infinity;
+    /// Сколько шагов подряд насыщения до прерывания; 0 - проверять только NaN/inf
+    int saturation_steps = 60;
+    /// Путь, засчитываемый прерванной траектории (с запасом больше, чем проезжает робот за time_limit = 15 с)
+    float cut_path = 100.0f;
+    /// Штраф гладкости прерванной траектории (с запасом больше, чем при управлении ±Umax с переключением на каждом шаге)
+    float cut_smoothness = 2000.0f;
+};
+
+/**
+ * @brief Проверка траектории по DivergenceGuard, один вызов на шаг
+ */
+class DivergenceMonitor {
+
+    public:
+        explicit DivergenceMonitor(const DivergenceGuard& guard);
+        /// Начать новую траекторию
+        void reset();
+        /// true - траекторию пора прервать
+        bool diverged(const Model::State& state, const Model::Control& rawControl);
+
+    private:
+        DivergenceGuard m_guard;
+        int m_saturatedSteps = 0;
+        int m_saturatedSigns = 0;
+};
+
+/**
+ * @brief Время, путь и штраф гладкости одной траектории для фитнеса робота
+ *
+ * Гладкость - сумма 0.1 * |ускорение| по шагам; ускорение считается по
+ * скоростям соседних шагов, в начале траектории скорость нулевая
+ */
+struct RolloutCost
+{
+    float time = 0.0f;
+    float path = 0.0f;
+    float smoothness = 0.0f;
+    Model::State last{0.0f, 0.0f, 0.0f};       // последнее учтённое (конечное) состояние
+    Model::State velocity{0.0f, 0.0f, 0.0f};   // скорость на последнем шаге (x, y)
+
+    /// Начать траекторию из init
+    void reset(const Model::State& init);
+    /// Учесть шаг длины dt, закончившийся в state
+    void addStep(const Model::State& state, float dt);
+    /**
+     * @brief Засчитать траекторию, прерванную DivergenceMonitor, как полную неудачную
+     *
+     * Время - timeLimit, путь и гладкость - не меньше guard.cut_path и guard.cut_smoothness:
+     * иначе они перестают накапливаться в момент прерывания, и раннее расхождение
+     * оказывается выгоднее доезда до timeLimit
+     */
+    void chargeCut(const DivergenceGuard& guard, float timeLimit);
+};
 
 class Runner {
 
@@ -11,10 +102,26 @@ class Runner {
         void init(const Model::State& goal);
         Model::State makeStep(); 
 
+        /// Заменить схему интегрирования (по умолчанию явный Эйлер)
+        void setIntegrator(std::unique_ptr<Integrator> integrator);
+        Integrator& integrator();
+
+        void setAdaptiveStepping(const AdaptiveStepping& adaptive);
+        /// Длина последнего сделанного шага (для фиксированного шага - dt модели)
+        float lastStepDt() const;
+
     private:
-        void Euler2();
+        Model::State makeAdaptiveStep();
 
     private:
         Model &m_model;
         Controller &m_controller;  
+        std::unique_ptr<Integrator> m_integrator;
+
+        AdaptiveStepping m_adaptive;
+        float m_baseDt;
+        float m_lastDt;
+        int m_stepMultiple = 1;
+        bool m_hasControl = false;
+        Model::Control m_control{0.0f, 0.0f}; // управление в текущей точке (из проверки прошлого шага)
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "model.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Бинарный колоночный формат траекторий (trajectories.bin)
+ * 
+ * Структура файла (little-endian):
+ *   TrajectoryFileHeader                      - 32 байта
+ *   блоки траекторий: для каждой траектории
+ *     float32[num_columns][num_samples]       - колонки Time, X, Y, Theta подряд
+ *   таблица индекса по смещению index_offset (выровнена на 8 байт):
+ *     uint64[num_trajectories][2]             - (смещение блока в байтах, num_samples)
+ * 
+ * Читается из numpy через np.memmap без копирования (см. viz_traj.py)
+ */
+struct TrajectoryFileHeader
+{
+    char magic[8];             // "NOPTRAJ\0"
+    uint32_t version;
+    uint32_t num_columns;
+    uint64_t num_trajectories;
+    uint64_t index_offset;
+};
+
+static_assert(sizeof(TrajectoryFileHeader) == 32, "TrajectoryFileHeader must be 32 bytes");
+
+
+class TrajectoryWriter
+{
+public:
+    static constexpr uint32_t Version = 1;
+    static constexpr uint32_t NumColumns = 4; // Time, X, Y, Theta
+
+    explicit TrajectoryWriter(size_t bufferSize = 1 << 20);
+    ~TrajectoryWriter();
+
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    bool open(const std::string& filepath);
+
+    /// Начать новую траекторию (предыдущая закрывается автоматически)
+    void beginTrajectory();
+    void addSample(float time, const Model::State& state);
+    void endTrajectory();
+
+    /// Дописать индекс и заголовок; вызывается и из деструктора
+    bool close();
+
+    size_t numTrajectories() const;
+
+private:
+    std::ofstream m_file;
+    std::vector<char> m_buffer;
+    std::vector<float> m_columns[NumColumns];
+    std::vector<uint64_t> m_index;   // пары (offset, num_samples)
+    uint64_t m_offset = 0;
+    bool m_inTrajectory = false;
+};
+
+
+/**
+ * @brief Прочитать trajectories.bin целиком
+ * 
+ * @param trajectories на выходе - по вектору на траекторию, колонки подряд
+ *        (Time[n], X[n], Y[n], Theta[n])
+ * @return true если успешно, false если ошибка
+ */
+bool readTrajectoryFile(const std::string& filepath, std::vector<std::vector<float>>& trajectories);
+
+/**
+ * @brief Экспорт trajectories.bin в CSV (Trajectory,Time,X,Y,Theta)
+ */
+bool exportTrajectoriesToCsv(const std::string& binPath, const std::string& csvPath);
@@ -0,0 +1,156 @@
+#include "integrator.hpp"
+
+#include <stdexcept>
+
+
+Integrator::Integrator(bool holdControl):
+    m_holdControl(holdControl)
+    { }
+
+bool Integrator::holdControl() const
+{
+    return m_holdControl;
+}
+
+Model::State Integrator::step(Model& model, Controller& controller, const Model::Control& u0)
+{
+    m_startControl = u0;
+    m_hasStartControl = true;
+    Model::State next = step(model, controller);
+    m_hasStartControl = false;
+    return next;
+}
+
+void Integrator::beginStep(Model& model)
+{
+    m_startVelocity = Model::Velocity{model.m_v, model.m_w};
+    m_hasCache = false;
+}
+
+Model::Velocity Integrator::stageVelocity(Model& model, Controller& controller, const Model::State& s)
+{
+    if (m_holdControl && m_hasCache)
+        return m_cachedVelocity;
+
+    // NN всегда стартует из скоростей начала шага
+    model.setVelocity(m_startVelocity.v, m_startVelocity.w);
+    Model::Control u = m_hasStartControl ? m_startControl : controller.calcControl(s);
+    m_hasStartControl = false;  // u0 относится только к первой стадии
+    m_cachedVelocity = model.nnVelocityFromControl(u);
+    m_hasCache = true;
+    return m_cachedVelocity;
+}
+
+void Integrator::endStep(Model& model, const Model::Velocity& vel)
+{
+    model.setVelocity(vel.v, vel.w);
+}
+
+
+Model::State EulerIntegrator::step(Model& model, Controller& controller)
+{
+    beginStep(model);
+    const float h = model.getDt();
+    const Model::State s0 = model.getState();
+
+    Model::Velocity v1 = stageVelocity(model, controller, s0);
+    Model::State next = s0 + Model::poseRate(s0, v1) * h;
+
+    endStep(model, v1);
+    return next;
+}
+
+Model::State HeunIntegrator::step(Model& model, Controller& controller)
+{
+    beginStep(model);
+    const float h = model.getDt();
+    const Model::State s0 = model.getState();
+
+    Model::Velocity v1 = stageVelocity(model, controller, s0);
+    Model::State k1 = Model::poseRate(s0, v1);
+
+    Model::State s1 = s0 + k1 * h;
+    Model::Velocity v2 = stageVelocity(model, controller, s1);
+    Model::State k2 = Model::poseRate(s1, v2);
+
+    Model::State next = s0 + (k1 + k2) * (0.5f * h);
+
+    endStep(model, Model::Velocity{0.5f * (v1.v + v2.v), 0.5f * (v1.w + v2.w)});
+    return next;
+}
+
+Model::State RK4Integrator::step(Model& model, Controller& controller)
+{
+    beginStep(model);
+    const float h = model.getDt();
+    const Model::State s0 = model.getState();
+
+    Model::Velocity v1 = stageVelocity(model, controller, s0);
+    Model::State k1 = Model::poseRate(s0, v1);
+
+    Model::State s2 = s0 + k1 * (0.5f * h);
+    Model::Velocity v2 = stageVelocity(model, controller, s2);
+    Model::State k2 = Model::poseRate(s2, v2);
+
+    Model::State s3 = s0 + k2 * (0.5f * h);
+    Model::Velocity v3 = stageVelocity(model, controller, s3);
+    Model::State k3 = Model::poseRate(s3, v3);
+
+    Model::State s4 = s0 + k3 * h;
+    Model::Velocity v4 = stageVelocity(model, controller, s4);
+    Model::State k4 = Model::poseRate(s4, v4);
+
+    Model::State next = s0 + (k1 + k2 * 2.0f + k3 * 2.0f + k4) * (h / 6.0f);
+
+    endStep(model, Model::Velocity{(v1.v + 2.0f * v2.v + 2.0f * v3.v + v4.v) / 6.0f,
+                                   (v1.w + 2.0f * v2.w + 2.0f * v3.w + v4.w) / 6.0f});
+    return next;
+}
+
+Model::State ArcIntegrator::step(Model& model, Controller& controller)
+{
+    beginStep(model);
+    const float h = model.getDt();
+    const Model::State s0 = model.getState();
+
+    Model::Velocity vel = stageVelocity(model, controller, s0);
+    Model::State next;
+
+    // при постоянных (v, w) робот движется по дуге окружности
+    const float dyaw = vel.w * h;
+    if (std::fabs(dyaw) < 1e-4f)
+    {
+        // почти прямолинейно: разложение до второго порядка
+        const float mid = s0.yaw + 0.5f * dyaw;
+        next = Model::State{s0.x + vel.v * h * cosf(mid),
+                            s0.y + vel.v * h * sinf(mid),
+                            s0.yaw + dyaw};
+    }
+    else
+    {
+        const float r = vel.v / vel.w;
+        next = Model::State{s0.x + r * (sinf(s0.yaw + dyaw) - sinf(s0.yaw)),
+                            s0.y - r * (cosf(s0.yaw + dyaw) - cosf(s0.yaw)),
+                            s0.yaw + dyaw};
+    }
+
+    endStep(model, vel);
+    return next;
+}
+
+
+std::unique_ptr<Integrator> makeIntegrator(IntegrationMethod method, bool holdControl)
+{
+    switch (method)
+    {
+    case IntegrationMethod::Euler:
+        return std::unique_ptr<Integrator>(new EulerIntegrator(holdControl));
+    case IntegrationMethod::Heun:
+        return std::unique_ptr<Integrator>(new HeunIntegrator(holdControl));
+    case IntegrationMethod::RK4:
+        return std::unique_ptr<Integrator>(new RK4Integrator(holdControl));
+    case IntegrationMethod::Arc:
+        return std::unique_ptr<Integrator>(new ArcIntegrator());
+    }
+    throw std::invalid_argument("Unknown integration method");
+}
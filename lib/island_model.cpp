@@ -0,0 +1,255 @@
+#include "island_model.hpp"
+#include "net_archive.hpp"
+#include "pareto_archive.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+
+IslandModel::IslandModel(const GAConfig& config, const IslandConfig& island_config)
+    : config_(config), island_config_(island_config), rng_(config.seed)
+{
+    if (island_config_.num_islands <= 0) {
+        throw std::invalid_argument("num_islands must be > 0");
+    }
+    if (island_config_.migration_interval <= 0) {
+        throw std::invalid_argument("migration_interval must be > 0");
+    }
+
+    for (int i = 0; i < island_config_.num_islands; ++i) {
+        // Острова отличаются только seed; колбэки, архив и чекпоинты - на уровне модели
+        GAConfig island = config_;
+        island.seed = config_.seed + static_cast<uint32_t>(i);
+        island.on_generation_end = nullptr;
+        island.on_algorithm_end = nullptr;
+        island.pareto_archive_path.clear();
+        island.elite_archive_path.clear();
+        island.checkpoint_path.clear();
+        islands_.push_back(std::make_unique<GANOP>(island));
+    }
+}
+
+void IslandModel::run()
+{
+    const int num_islands = numIslands();
+    std::vector<std::exception_ptr> errors(num_islands);
+
+    // Запускает на каждом острове свой поток, ждёт завершения всех
+    auto parallel = [&](const std::function<void(GANOP&)>& task) {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_islands; ++i) {
+            threads.emplace_back([&, i]() {
+                try {
+                    task(*islands_[i]);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+
+    std::cout << "Initializing " << num_islands << " islands..." << std::endl;
+    parallel([](GANOP& ga) { ga.initialize(); });
+    reportGeneration(0);
+
+    for (int generation = 1; generation <= config_.num_generations;) {
+        const int last = std::min(config_.num_generations, generation + island_config_.migration_interval - 1);
+
+        parallel([generation, last](GANOP& ga) {
+            for (int g = generation; g <= last; ++g) {
+                ga.runGeneration(g);
+            }
+        });
+
+        if (last < config_.num_generations) {
+            migrate();
+        }
+        reportGeneration(last);
+        generation = last + 1;
+    }
+
+    for (auto& island : islands_) {
+        island->finish();
+    }
+
+    const int best_island = getBestIsland();
+    std::cout << "Best solution found on island " << best_island << std::endl;
+
+    if (!config_.pareto_archive_path.empty()) {
+        if (saveParetoArchive(config_.pareto_archive_path)) {
+            std::cout << "Pareto fronts of all islands saved to " << config_.pareto_archive_path << std::endl;
+        } else {
+            std::cerr << "WARNING: Failed to save " << config_.pareto_archive_path << std::endl;
+        }
+    }
+
+    if (!config_.elite_archive_path.empty()) {
+        if (saveEliteArchive(config_.elite_archive_path)) {
+            std::cout << "Elite archives of all islands saved to " << config_.elite_archive_path << std::endl;
+        } else {
+            std::cerr << "WARNING: Failed to save " << config_.elite_archive_path << std::endl;
+        }
+    }
+
+    if (config_.on_algorithm_end) {
+        const Migrant best = islands_[best_island]->emigrants(1).front();
+        auto best_solution = config_.solution_factory();
+        best_solution->decode(best.params, best.structure);
+        config_.on_algorithm_end(*best_solution);
+    }
+}
+
+int IslandModel::numIslands() const
+{
+    return static_cast<int>(islands_.size());
+}
+
+const GANOP& IslandModel::island(int i) const
+{
+    return *islands_.at(i);
+}
+
+int IslandModel::getBestIsland() const
+{
+    int best_island = 0;
+    float best_value = 0.0f;
+    for (int i = 0; i < numIslands(); ++i) {
+        const FitnessMatrix& fitness = islands_[i]->getFitnessMatrix();
+        const float value = fitness.at(islands_[i]->getBestParetoIndex(), fitness.numObjectives() - 1);
+        if (i == 0 || value < best_value) {
+            best_value = value;
+            best_island = i;
+        }
+    }
+    return best_island;
+}
+
+std::vector<int> IslandModel::migrationTargets(int source)
+{
+    const int num_islands = numIslands();
+    std::vector<int> targets;
+    if (num_islands < 2) {
+        return targets;
+    }
+
+    switch (island_config_.topology) {
+    case MigrationTopology::Ring:
+        targets.push_back((source + 1) % num_islands);
+        break;
+
+    case MigrationTopology::FullyConnected:
+        for (int i = 0; i < num_islands; ++i) {
+            if (i != source) {
+                targets.push_back(i);
+            }
+        }
+        break;
+
+    case MigrationTopology::Random: {
+        std::uniform_int_distribution<int> dist(0, num_islands - 2);
+        int target = dist(rng_);
+        targets.push_back(target >= source ? target + 1 : target);
+        break;
+    }
+    }
+    return targets;
+}
+
+void IslandModel::migrate()
+{
+    // Сначала собираем всех эмигрантов, чтобы принятые на этой миграции
+    // особи не уходили дальше по кольцу в тот же раз
+    std::vector<std::vector<Migrant>> outgoing;
+    for (const auto& island : islands_) {
+        outgoing.push_back(island->emigrants(island_config_.migrants_per_island));
+    }
+
+    std::vector<std::vector<Migrant>> incoming(numIslands());
+    for (int source = 0; source < numIslands(); ++source) {
+        for (int target : migrationTargets(source)) {
+            incoming[target].insert(incoming[target].end(), outgoing[source].begin(), outgoing[source].end());
+        }
+    }
+
+    int accepted = 0;
+    for (int i = 0; i < numIslands(); ++i) {
+        accepted += islands_[i]->immigrate(incoming[i]);
+    }
+    std::cout << "Migration: " << accepted << " individuals accepted" << std::endl;
+}
+
+void IslandModel::reportGeneration(int generation) const
+{
+    if (!config_.on_generation_end) {
+        return;
+    }
+
+    float sum_fitness = 0.0f;
+    int count = 0;
+    for (const auto& island : islands_) {
+        const FitnessMatrix& fitness = island->getFitnessMatrix();
+        for (size_t i = 0; i < fitness.size(); ++i) {
+            sum_fitness += fitness.at(i, fitness.numObjectives() - 1);
+            ++count;
+        }
+    }
+    config_.on_generation_end(generation, count > 0 ? sum_fitness / static_cast<float>(count) : 0.0f);
+}
+
+bool IslandModel::saveParetoArchive(const std::string& filepath) const
+{
+    NetArchiveWriter writer;
+    const int num_obj = config_.fitness_evaluator->getNumObjectives();
+    if (!writer.open(filepath, static_cast<uint32_t>(num_obj), config_.fitness_evaluator->getConfigHash())) {
+        return false;
+    }
+
+    for (const auto& island : islands_) {
+        const int front_size = static_cast<int>(island->getParetoIndices().size());
+        for (const auto& migrant : island->emigrants(front_size)) {
+            auto solution = config_.solution_factory();
+            solution->decode(migrant.params, migrant.structure);
+            if (!writer.add(solution->getNetOperConst(), migrant.fitness)) {
+                return false;
+            }
+        }
+    }
+    return writer.close();
+}
+
+bool IslandModel::saveEliteArchive(const std::string& filepath) const
+{
+    // Архивы островов объединяются: решение, доминируемое чужим, отбрасывается
+    const int num_obj = config_.fitness_evaluator->getNumObjectives();
+    ParetoArchive merged(static_cast<size_t>(num_obj));
+    for (const auto& island : islands_) {
+        for (const ParetoArchiveEntry* elite : island->getEliteArchive().entries()) {
+            merged.insert(*elite);
+        }
+    }
+
+    NetArchiveWriter writer;
+    if (!writer.open(filepath, static_cast<uint32_t>(num_obj), config_.fitness_evaluator->getConfigHash())) {
+        return false;
+    }
+    for (const ParetoArchiveEntry* elite : merged.entries()) {
+        auto solution = config_.solution_factory();
+        solution->decode(elite->params, elite->structure);
+        if (!writer.add(solution->getNetOperConst(), elite->fitness)) {
+            return false;
+        }
+    }
+    return writer.close();
+}
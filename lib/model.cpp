@@ -68,7 +68,22 @@ Model::Model(const State &state, float dt, const std::string &onnx_path)
       : m_currentState(state),
         m_dt(dt),
         m_env(ORT_LOGGING_LEVEL_WARNING, "RobotNN"),
-        m_session(m_env, onnx_path.c_str(), Ort::SessionOptions{}) {}
+        m_session(m_env, onnx_path.c_str(), Ort::SessionOptions{}),
+        m_memInfo(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)),
+        m_inputTensor(nullptr),
+        m_outputTensor(nullptr)
+{
+  Ort::AllocatorWithDefaultOptions allocator;
+  m_inputName = m_session.GetInputNameAllocated(0, allocator).get();
+  m_outputName = m_session.GetOutputNameAllocated(0, allocator).get();
+
+  const std::array<int64_t, 2> input_dims{1, 5};
+  const std::array<int64_t, 2> output_dims{1, 2};
+  m_inputTensor = Ort::Value::CreateTensor<float>(
+      m_memInfo, m_input.data(), m_input.size(), input_dims.data(), input_dims.size());
+  m_outputTensor = Ort::Value::CreateTensor<float>(
+      m_memInfo, m_output.data(), m_output.size(), output_dims.data(), output_dims.size());
+}
 
 void Model::setState(const Model::State &state) 
 { 
@@ -106,50 +121,46 @@ Model::State Model::nextStateFromControl(const Model::Control &u)
 }
 
 
-Model::State Model::nextNNStateFromControl(const Model::Control &u) {
-    // вход: [v_current, w_current, v_control, w_control, dt]
-    // float u_v = k * (u.left + u.right);
-    // float u_w = k_w * k * (u.left - u.right);
-    std::array<float, 5> input_vals = {m_v, m_w, u.left, u.right, m_dt};
-    std::array<int64_t, 2> dims{1, 5};
-
-    Ort::MemoryInfo mem_info =
-        Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-
-    Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
-        mem_info, input_vals.data(), input_vals.size(), dims.data(), dims.size());
-
-    Ort::AllocatorWithDefaultOptions allocator;
-
-    // Получаем имена входов/выходов
-    Ort::AllocatedStringPtr input_name = m_session.GetInputNameAllocated(0, allocator);
-    Ort::AllocatedStringPtr output_name = m_session.GetOutputNameAllocated(0, allocator);
-
-    std::vector<const char*> input_names{input_name.get()};
-    std::vector<const char*> output_names{output_name.get()};
+float Model::getDt() const
+{
+  return m_dt;
+}
 
-    // Запуск инференса
-    auto outputs = m_session.Run(Ort::RunOptions{nullptr},
-                                input_names.data(), &input_tensor, 1,
-                                output_names.data(), 1);
+void Model::setDt(float dt)
+{
+  m_dt = dt;
+}
 
-    // достаём результат
-    float *out_data = outputs[0].GetTensorMutableData<float>();
-    m_v = out_data[0]; // новая линейная скорость
-    m_w = out_data[1]; // новая угловая скорость
+Model::State Model::poseRate(const Model::State &state, const Model::Velocity &vel)
+{
+  return State{vel.v * cosf(state.yaw),
+               vel.v * sinf(state.yaw),
+               vel.w};
+}
 
+Model::Velocity Model::nnVelocityFromControl(const Model::Control &u) {
+    // вход: [v_current, w_current, v_control, w_control, dt]
+    // float u_v = k * (u.left + u.right);
+    // float u_w = k_w * k * (u.left - u.right);
+    m_input = {m_v, m_w, u.left, u.right, m_dt};
 
-      // TETS
+    const char* input_names[] = {m_inputName.c_str()};
+    const char* output_names[] = {m_outputName.c_str()};
 
-    // return  State{(m_v) * cosf(m_currentState.yaw),
-    //           (m_v) * sinf(m_currentState.yaw),
-    //           (m_w)};
+    // Запуск инференса в заранее созданный выходной тензор
+    m_session.Run(Ort::RunOptions{nullptr},
+                  input_names, &m_inputTensor, 1,
+                  output_names, &m_outputTensor, 1);
 
-    auto vel =  State{(m_v) * cosf(m_currentState.yaw),
-          (m_v) * sinf(m_currentState.yaw),
-          (m_w)};
-    
-    return nextStateFromVelocity(vel);
+    // новая линейная и угловая скорость
+    return Velocity{m_output[0], m_output[1]};
+}
 
-  }
+Model::State Model::nextNNStateFromControl(const Model::Control &u) {
+    Velocity vel = nnVelocityFromControl(u);
+    m_v = vel.v;
+    m_w = vel.w;
 
+    State rate = poseRate(m_currentState, vel);
+    return nextStateFromVelocity(rate);
+}
@@ -0,0 +1,225 @@
+#include "net_archive.hpp"
+
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+
+constexpr char ArchiveMagic[8] = {'N', 'O', 'P', 'A', 'R', 'C', 'H', '\0'};
+
+}
+
+constexpr uint32_t NetArchiveWriter::Version;
+
+
+NetArchiveWriter::~NetArchiveWriter()
+{
+    close();
+}
+
+bool NetArchiveWriter::open(const std::string& filepath, uint32_t num_objectives, uint64_t config_hash)
+{
+    close();
+
+    m_file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        std::cerr << "ERROR: Could not open archive for writing: " << filepath << std::endl;
+        return false;
+    }
+
+    // заголовок перезаписывается в close()
+    NetArchiveHeader header{};
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_offset = sizeof(header);
+    m_numObjectives = num_objectives;
+    m_configHash = config_hash;
+    m_entries.clear();
+    m_fitness.clear();
+    return true;
+}
+
+bool NetArchiveWriter::add(const NetOper& net)
+{
+    return add(net, std::vector<float>(m_numObjectives, 0.0f));
+}
+
+bool NetArchiveWriter::add(const NetOper& net, const std::vector<float>& fitness)
+{
+    if (!m_file.is_open())
+        return false;
+    if (fitness.size() != m_numObjectives) {
+        std::cerr << "ERROR: Archive expects " << m_numObjectives << " objectives, got "
+                  << fitness.size() << std::endl;
+        return false;
+    }
+    if (!net.toBinary(m_image))
+        return false;
+
+    m_entries.push_back(NetArchiveEntry{m_offset, m_image.size()});
+    m_fitness.insert(m_fitness.end(), fitness.begin(), fitness.end());
+
+    // выравнивание следующего образа на 8 байт
+    const size_t pad = (8 - m_image.size() % 8) % 8;
+    m_image.resize(m_image.size() + pad, 0);
+    m_file.write(m_image.data(), m_image.size());
+    m_offset += m_image.size();
+    return m_file.good();
+}
+
+bool NetArchiveWriter::close()
+{
+    if (!m_file.is_open())
+        return false;
+
+    NetArchiveHeader header{};
+    std::memcpy(header.magic, ArchiveMagic, sizeof(header.magic));
+    header.version = Version;
+    header.num_objectives = m_numObjectives;
+    header.num_networks = m_entries.size();
+    header.index_offset = m_offset;
+    header.config_hash = m_configHash;
+
+    m_file.write(reinterpret_cast<const char*>(m_entries.data()), m_entries.size() * sizeof(NetArchiveEntry));
+    m_file.write(reinterpret_cast<const char*>(m_fitness.data()), m_fitness.size() * sizeof(float));
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const bool ok = m_file.good();
+    m_file.close();
+    if (!ok)
+        std::cerr << "ERROR: Failed to write network archive" << std::endl;
+    return ok;
+}
+
+size_t NetArchiveWriter::size() const
+{
+    return m_entries.size();
+}
+
+
+NetArchive::~NetArchive()
+{
+    close();
+}
+
+bool NetArchive::open(const std::string& filepath)
+{
+    close();
+
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "ERROR: Could not open archive: " << filepath << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(NetArchiveHeader))) {
+        std::cerr << "ERROR: Archive is too small: " << filepath << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "ERROR: Could not mmap archive: " << filepath << std::endl;
+        return false;
+    }
+
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<size_t>(st.st_size);
+    m_header = reinterpret_cast<const NetArchiveHeader*>(m_data);
+
+    if (std::memcmp(m_header->magic, ArchiveMagic, sizeof(ArchiveMagic)) != 0 ||
+        m_header->version != NetArchiveWriter::Version) {
+        std::cerr << "ERROR: Not a network archive (or unsupported version): " << filepath << std::endl;
+        close();
+        return false;
+    }
+
+    // Заголовок не доверенный: размеры проверяются делением и вычитанием, без переполнения uint64
+    const uint64_t numNetworks = m_header->num_networks;
+    const uint64_t fitnessPerNetwork = static_cast<uint64_t>(m_header->num_objectives) * sizeof(float);
+    bool valid = m_header->index_offset % 8 == 0 && m_header->index_offset <= m_size;
+    uint64_t remaining = valid ? m_size - m_header->index_offset : 0;
+    valid = valid && numNetworks <= remaining / sizeof(NetArchiveEntry);
+    const uint64_t indexBytes = valid ? numNetworks * sizeof(NetArchiveEntry) : 0;
+    remaining -= indexBytes;
+    valid = valid && (fitnessPerNetwork == 0 || numNetworks <= remaining / fitnessPerNetwork);
+    if (!valid) {
+        std::cerr << "ERROR: Archive index is truncated: " << filepath << std::endl;
+        close();
+        return false;
+    }
+
+    m_entries = reinterpret_cast<const NetArchiveEntry*>(m_data + m_header->index_offset);
+    if (m_header->num_objectives > 0)
+        m_fitness = reinterpret_cast<const float*>(m_data + m_header->index_offset + indexBytes);
+    return true;
+}
+
+void NetArchive::close()
+{
+    if (m_data)
+        munmap(const_cast<char*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_entries = nullptr;
+    m_fitness = nullptr;
+}
+
+bool NetArchive::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+size_t NetArchive::size() const
+{
+    return m_header ? static_cast<size_t>(m_header->num_networks) : 0;
+}
+
+uint32_t NetArchive::numObjectives() const
+{
+    return m_header ? m_header->num_objectives : 0;
+}
+
+uint64_t NetArchive::configHash() const
+{
+    return m_header ? m_header->config_hash : 0;
+}
+
+const char* NetArchive::image(size_t i, size_t& imageSize) const
+{
+    if (i >= size())
+        return nullptr;
+    const NetArchiveEntry& entry = m_entries[i];
+    if (entry.offset > m_size || entry.size > m_size - entry.offset)
+        return nullptr;
+    imageSize = static_cast<size_t>(entry.size);
+    return m_data + entry.offset;
+}
+
+bool NetArchive::get(size_t i, NetOper& net) const
+{
+    size_t imageSize = 0;
+    const char* data = image(i, imageSize);
+    if (!data) {
+        std::cerr << "ERROR: Network " << i << " is out of archive bounds" << std::endl;
+        return false;
+    }
+    return net.fromBinary(data, imageSize);
+}
+
+const float* NetArchive::fitness(size_t i) const
+{
+    if (!m_fitness || i >= size())
+        return nullptr;
+    return m_fitness + i * m_header->num_objectives;
+}
@@ -1,8 +1,69 @@
 #include "nop.hpp"
+#include <cstring>
 #include <iostream>
 #include <random>
 
 
+namespace {
+
+constexpr char NetOperMagic[8] = {'N', 'O', 'P', 'N', 'E', 'T', '\0', '\0'};
+
+uint32_t fnv1a(const char* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename T>
+void appendRaw(std::vector<char>& out, const T& value)
+{
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool readRaw(const char*& it, const char* end, T& value)
+{
+    if (static_cast<size_t>(end - it) < sizeof(T))
+        return false;
+    std::memcpy(&value, it, sizeof(T));
+    it += sizeof(T);
+    return true;
+}
+
+bool appendNodes(std::vector<char>& out, const std::vector<int>& nodes)
+{
+    for (int node : nodes) {
+        if (node < 0 || node > 0xFFFF)
+            return false;
+        appendRaw(out, static_cast<uint16_t>(node));
+    }
+    return true;
+}
+
+/// Узлы из образа; false - образ обрезан или узел вне матрицы размера size
+bool readNodes(const char*& it, const char* end, uint32_t count, size_t size, std::vector<int>& nodes)
+{
+    // размер проверяется до выделения памяти: count берётся из непроверенного заголовка
+    if (static_cast<size_t>(end - it) / sizeof(uint16_t) < count)
+        return false;
+    nodes.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint16_t node = 0;
+        if (!readRaw(it, end, node) || node >= size)
+            return false;
+        nodes[i] = node;
+    }
+    return true;
+}
+
+}
+
+
 NetOper::NetOper()
 {
     initUnaryFunctionsMap();
@@ -63,7 +124,7 @@ void NetOper::initBinaryFunctionsMap()
     m_binaryFuncMap[8] = xi_8;
 }
 
-const std::vector<int>& NetOper::getNodesForVars()
+const std::vector<int>& NetOper::getNodesForVars() const
 {
     return m_nodesForVars;
 }
@@ -73,7 +134,7 @@ void NetOper::setNodesForVars(const std::vector<int>& nodes)
     m_nodesForVars = nodes;
 }
 
-const std::vector<int>& NetOper::getNodesForParams()
+const std::vector<int>& NetOper::getNodesForParams() const
 {
     return m_nodesForParams;
 }
@@ -83,7 +144,7 @@ void NetOper::setNodesForParams(const std::vector<int>& nodes)
     m_nodesForParams = nodes;
 }
 
-const std::vector<int>& NetOper::getNodesForOutput()
+const std::vector<int>& NetOper::getNodesForOutput() const
 {
     return m_nodesForOutput;
 }
@@ -93,12 +154,12 @@ void NetOper::setNodesForOutput(const std::vector<int>& nodes)
     m_nodesForOutput = nodes;
 }
 
-const std::vector<std::vector<int>>& NetOper::getPsi()
+const std::vector<std::vector<int>>& NetOper::getPsi() const
 {
     return m_matrix;
 }
 
-const std::vector<float>& NetOper::getCs()
+const std::vector<float>& NetOper::getCs() const
 {
     return m_parameters;
 }
@@ -115,6 +176,11 @@ void NetOper::setPsi(const std::vector<std::vector<int>>& newMatrix)
 }
 // ROControl
 void NetOper::calcResult(const std::vector<float>& x_in, std::vector<float>& y_out)
+{
+    calcResult(x_in.data(), y_out.data());
+}
+
+void NetOper::calcResult(const float* x_in, float* y_out)
 {
     for(size_t i=0; i < m_matrix.size(); ++i)
     {
@@ -179,7 +245,8 @@ bool NetOper::TestSource(int j)
     return true;
 }
 
-void NetOper::GenVar(std::vector<int>& w)
+template <typename Random>
+void NetOper::genVar(std::vector<int>& w, Random&& random)
 {
     // Элементарные операции
     if (w.size() < 4) w.resize(4);
@@ -188,23 +255,23 @@ void NetOper::GenVar(std::vector<int>& w)
     int kW = static_cast<int>(m_unaryFuncMap.size());
     int kV = static_cast<int>(m_binaryFuncMap.size());
 
-    w[0] = rand() % 4; // random(4)
+    w[0] = random(4);
 
     switch (w[0])
     {
     case 0:
     case 2:
     case 3: // замена недиагонального элемента, добавление и удаление дуги
-        w[1] = rand() % (L - 1);
-        w[2] = rand() % (L - w[1] - 1) + w[1] + 1;
-        w[3] = rand() % kW;
+        w[1] = random(L - 1);
+        w[2] = random(L - w[1] - 1) + w[1] + 1;
+        w[3] = random(kW);
         // if (w[3] == 0)
         //     w[3] = 1;
-        w[3] = (rand() % kW) + 1; 
+        w[3] = random(kW) + 1; 
         break;
 
     case 1: // замена диагонального элемента
-        w[1] = rand() % L;
+        w[1] = random(L);
 
         // while (w[1] < L && !TestSource(w[1]))
         //     w[1]++;
@@ -230,11 +297,21 @@ void NetOper::GenVar(std::vector<int>& w)
         // w[3] = rand() % kV;
         // if (w[3] == 0)
         //     w[3] = 1;
-        w[3] = (rand() % kV) + 1;
+        w[3] = random(kV) + 1;
         break;
     }
 }
 
+void NetOper::GenVar(std::vector<int>& w)
+{
+    genVar(w, [](int n) { return rand() % n; });
+}
+
+void NetOper::GenVar(std::vector<int>& w, CounterRng& rng)
+{
+    genVar(w, [&rng](int n) { return rng.uniformInt(n); });
+}
+
 // приминение вариации
 void NetOper::Variations(const std::vector<int>& w)
 {
@@ -527,6 +604,192 @@ bool NetOper::saveParametersToFile(const std::string& filepath) const
     return true;
 }
 
+bool NetOper::toBinary(std::vector<char>& out) const
+{
+    const size_t L = m_matrix.size();
+    if (L > 0xFFFF) {
+        std::cerr << "ERROR: Matrix is too large for binary format: " << L << std::endl;
+        return false;
+    }
+
+    NetOperBinaryHeader header{};
+    std::memcpy(header.magic, NetOperMagic, sizeof(header.magic));
+    header.version = NetOperBinaryVersion;
+    header.size = static_cast<uint32_t>(L);
+    header.num_params = static_cast<uint32_t>(m_parameters.size());
+    header.num_vars = static_cast<uint32_t>(m_nodesForVars.size());
+    header.num_param_nodes = static_cast<uint32_t>(m_nodesForParams.size());
+    header.num_outputs = static_cast<uint32_t>(m_nodesForOutput.size());
+
+    out.clear();
+    out.resize(sizeof(header));
+
+    // Диагональ
+    for (size_t i = 0; i < L; ++i) {
+        if (m_matrix[i].size() != L) {
+            std::cerr << "ERROR: Binary format requires a square matrix" << std::endl;
+            return false;
+        }
+        if (m_matrix[i][i] < 0 || m_matrix[i][i] > 0xFF) {
+            std::cerr << "ERROR: Diagonal value out of range at " << i << std::endl;
+            return false;
+        }
+        out.push_back(static_cast<char>(m_matrix[i][i]));
+    }
+
+    // Дуги - только ненулевые недиагональные элементы
+    for (size_t i = 0; i < L; ++i) {
+        for (size_t j = 0; j < L; ++j) {
+            if (i == j || m_matrix[i][j] == 0)
+                continue;
+            if (m_matrix[i][j] < 0 || m_matrix[i][j] > 0xFFFF) {
+                std::cerr << "ERROR: Arc value out of range at " << i << ", " << j << std::endl;
+                return false;
+            }
+            appendRaw(out, static_cast<uint16_t>(i));
+            appendRaw(out, static_cast<uint16_t>(j));
+            appendRaw(out, static_cast<uint16_t>(m_matrix[i][j]));
+            header.num_arcs++;
+        }
+    }
+
+    for (float param : m_parameters)
+        appendRaw(out, param);
+
+    if (!appendNodes(out, m_nodesForVars) ||
+        !appendNodes(out, m_nodesForParams) ||
+        !appendNodes(out, m_nodesForOutput)) {
+        std::cerr << "ERROR: Node index out of range for binary format" << std::endl;
+        return false;
+    }
+
+    header.checksum = fnv1a(out.data() + sizeof(header), out.size() - sizeof(header));
+    std::memcpy(out.data(), &header, sizeof(header));
+    return true;
+}
+
+bool NetOper::fromBinary(const char* data, size_t size)
+{
+    NetOperBinaryHeader header{};
+    const char* it = data;
+    const char* end = data + size;
+
+    if (!readRaw(it, end, header) ||
+        std::memcmp(header.magic, NetOperMagic, sizeof(header.magic)) != 0) {
+        std::cerr << "ERROR: Not a NetOper binary image" << std::endl;
+        return false;
+    }
+    if (header.version != NetOperBinaryVersion) {
+        std::cerr << "ERROR: Unsupported NetOper binary version " << header.version << std::endl;
+        return false;
+    }
+    if (fnv1a(it, end - it) != header.checksum) {
+        std::cerr << "ERROR: NetOper binary checksum mismatch" << std::endl;
+        return false;
+    }
+
+    // Образ приходит из архивов и от удалённых процессов: контрольная сумма ловит
+    // только случайную порчу, поэтому размеры, операции и узлы проверяются явно,
+    // а размеры - до выделения памяти
+    const size_t L = header.size;
+    const size_t remaining = static_cast<size_t>(end - it);
+    if (L == 0 || L > 0xFFFF || remaining < L ||
+        (remaining - L) / (3 * sizeof(uint16_t)) < header.num_arcs) {
+        std::cerr << "ERROR: NetOper binary image is truncated" << std::endl;
+        return false;
+    }
+
+    std::vector<std::vector<int>> matrix(L, std::vector<int>(L, 0));
+    for (size_t i = 0; i < L; ++i) {
+        const uint8_t op = static_cast<uint8_t>(*it++);
+        if (op > NumBinaryFunctions) {
+            std::cerr << "ERROR: Unknown node operation " << static_cast<int>(op) << " in NetOper binary image" << std::endl;
+            return false;
+        }
+        matrix[i][i] = op;
+    }
+
+    for (uint32_t k = 0; k < header.num_arcs; ++k) {
+        uint16_t row = 0, col = 0, op = 0;
+        if (!readRaw(it, end, row) || !readRaw(it, end, col) || !readRaw(it, end, op) ||
+            row >= L || col >= L || row == col) {
+            std::cerr << "ERROR: Corrupted arc list in NetOper binary image" << std::endl;
+            return false;
+        }
+        // дуга выше диагонали вычисляется операцией узла назначения, значит она должна быть задана
+        if (op < 1 || op > NumUnaryFunctions || (row < col && matrix[col][col] == 0)) {
+            std::cerr << "ERROR: Unknown arc operation " << op << " in NetOper binary image" << std::endl;
+            return false;
+        }
+        matrix[row][col] = op;
+    }
+
+    if (static_cast<size_t>(end - it) / sizeof(float) < header.num_params ||
+        header.num_param_nodes > header.num_params) {
+        std::cerr << "ERROR: NetOper binary image has fewer parameters than parameter nodes or is truncated" << std::endl;
+        return false;
+    }
+    std::vector<float> params(header.num_params);
+    for (auto& param : params)
+        readRaw(it, end, param);
+
+    std::vector<int> vars, paramNodes, outputs;
+    if (!readNodes(it, end, header.num_vars, L, vars) ||
+        !readNodes(it, end, header.num_param_nodes, L, paramNodes) ||
+        !readNodes(it, end, header.num_outputs, L, outputs)) {
+        std::cerr << "ERROR: NetOper binary image is truncated or has nodes outside the matrix" << std::endl;
+        return false;
+    }
+
+    m_matrix.swap(matrix);
+    z.resize(m_matrix.size());
+    m_parameters.swap(params);
+    m_nodesForVars.swap(vars);
+    m_nodesForParams.swap(paramNodes);
+    m_nodesForOutput.swap(outputs);
+    return true;
+}
+
+bool NetOper::saveToBinaryFile(const std::string& filepath) const
+{
+    std::vector<char> image;
+    if (!toBinary(image))
+        return false;
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open network file for writing: " << filepath << std::endl;
+        return false;
+    }
+
+    file.write(image.data(), image.size());
+    return file.good();
+}
+
+bool NetOper::loadFromBinaryFile(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open network file: " << filepath << std::endl;
+        return false;
+    }
+
+    const std::streamsize size = file.tellg();
+    if (size <= 0) {
+        std::cerr << "ERROR: Network file is empty: " << filepath << std::endl;
+        return false;
+    }
+    file.seekg(0);
+
+    std::vector<char> image(static_cast<size_t>(size));
+    if (!file.read(image.data(), size)) {
+        std::cerr << "ERROR: Could not read network file: " << filepath << std::endl;
+        return false;
+    }
+
+    return fromBinary(image.data(), image.size());
+}
+
 const std::vector<std::vector<int>> NopPsiN = {
     {1, 0, 0, 0, 0, 0, 1, 10, 0, 0, 12, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 10},
     {0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 19, 0, 0, 0, 0},
@@ -0,0 +1,353 @@
+#include "pareto_archive.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+
+namespace {
+
+/// Максимум точек в листе; переполненный лист делится на M + 1 потомков
+constexpr size_t MaxLeafSize = 20;
+
+/// a не хуже b по всем критериям
+inline bool covers(const float* a, const float* b, size_t num_objectives)
+{
+    for (size_t j = 0; j < num_objectives; ++j) {
+        if (a[j] > b[j]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline float squaredDistance(const float* a, const float* b, size_t num_objectives)
+{
+    float sum = 0.0f;
+    for (size_t j = 0; j < num_objectives; ++j) {
+        const float d = a[j] - b[j];
+        sum += d * d;
+    }
+    return sum;
+}
+
+}
+
+
+struct ParetoArchive::Node
+{
+    std::vector<float> ideal;   // покомпонентный минимум точек поддерева
+    std::vector<float> nadir;   // покомпонентный максимум
+    std::vector<std::unique_ptr<Node>> children;
+    std::vector<int> points;    // id решений (только в листе)
+
+    bool isLeaf() const { return children.empty(); }
+    bool isEmpty() const { return children.empty() && points.empty(); }
+};
+
+
+ParetoArchive::ParetoArchive(size_t num_objectives)
+    : m_numObjectives(num_objectives)
+{}
+
+ParetoArchive::~ParetoArchive() = default;
+ParetoArchive::ParetoArchive(ParetoArchive&&) noexcept = default;
+ParetoArchive& ParetoArchive::operator=(ParetoArchive&&) noexcept = default;
+
+void ParetoArchive::reset(size_t num_objectives)
+{
+    m_numObjectives = num_objectives;
+    m_size = 0;
+    m_root.reset();
+    m_entries.clear();
+    m_alive.clear();
+    m_free.clear();
+    m_sequence.clear();
+    m_nextSequence = 0;
+}
+
+bool ParetoArchive::insert(const ParetoArchiveEntry& entry)
+{
+    if (entry.fitness.size() != m_numObjectives) {
+        throw std::invalid_argument("ParetoArchive: wrong number of objectives");
+    }
+    for (float f : entry.fitness) {
+        if (!std::isfinite(f)) {
+            return false;
+        }
+    }
+
+    const float* fitness = entry.fitness.data();
+    if (m_root && covered(*m_root, fitness)) {
+        return false;
+    }
+    if (m_root) {
+        removeCovered(*m_root, fitness);
+    }
+
+    int id;
+    if (!m_free.empty()) {
+        id = m_free.back();
+        m_free.pop_back();
+        m_entries[id] = entry;
+        m_alive[id] = 1;
+        m_sequence[id] = m_nextSequence++;
+    } else {
+        id = static_cast<int>(m_entries.size());
+        m_entries.push_back(entry);
+        m_alive.push_back(1);
+        m_sequence.push_back(m_nextSequence++);
+    }
+    ++m_size;
+
+    if (!m_root) {
+        m_root.reset(new Node());
+    }
+    insertInto(*m_root, id);
+    return true;
+}
+
+bool ParetoArchive::isDominated(const float* fitness) const
+{
+    return m_root && covered(*m_root, fitness);
+}
+
+std::vector<const ParetoArchiveEntry*> ParetoArchive::entries() const
+{
+    std::vector<int> ids;
+    ids.reserve(m_size);
+    for (size_t id = 0; id < m_entries.size(); ++id) {
+        if (m_alive[id]) {
+            ids.push_back(static_cast<int>(id));
+        }
+    }
+    // Номера занятых ячеек переиспользуются, поэтому порядок - по номеру добавления
+    std::sort(ids.begin(), ids.end(), [this](int a, int b) { return m_sequence[a] < m_sequence[b]; });
+
+    std::vector<const ParetoArchiveEntry*> result;
+    result.reserve(ids.size());
+    for (int id : ids) {
+        result.push_back(&m_entries[id]);
+    }
+    return result;
+}
+
+
+bool ParetoArchive::covered(const Node& node, const float* fitness) const
+{
+    if (node.isEmpty() || !covers(node.ideal.data(), fitness, m_numObjectives)) {
+        return false;
+    }
+    // Все точки узла не хуже nadir, значит и кандидата
+    if (covers(node.nadir.data(), fitness, m_numObjectives)) {
+        return true;
+    }
+
+    if (node.isLeaf()) {
+        for (int id : node.points) {
+            if (covers(point(id), fitness, m_numObjectives)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    for (const auto& child : node.children) {
+        if (covered(*child, fitness)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParetoArchive::removeCovered(Node& node, const float* fitness)
+{
+    if (node.isEmpty() || !covers(fitness, node.nadir.data(), m_numObjectives)) {
+        return;
+    }
+    // Кандидат не хуже ideal - доминирует весь узел
+    if (covers(fitness, node.ideal.data(), m_numObjectives)) {
+        releaseAll(node);
+        return;
+    }
+
+    if (node.isLeaf()) {
+        auto kept = node.points.begin();
+        for (int id : node.points) {
+            if (covers(fitness, point(id), m_numObjectives)) {
+                m_alive[id] = 0;
+                m_entries[id] = ParetoArchiveEntry();
+                m_free.push_back(id);
+                --m_size;
+            } else {
+                *kept++ = id;
+            }
+        }
+        node.points.erase(kept, node.points.end());
+    } else {
+        for (auto& child : node.children) {
+            removeCovered(*child, fitness);
+        }
+        node.children.erase(std::remove_if(node.children.begin(), node.children.end(),
+                                           [](const std::unique_ptr<Node>& child) { return child->isEmpty(); }),
+                            node.children.end());
+
+        // Единственный потомок поднимается на место узла
+        if (node.children.size() == 1) {
+            std::unique_ptr<Node> only = std::move(node.children.front());
+            node.children = std::move(only->children);
+            node.points = std::move(only->points);
+        }
+    }
+
+    updateBounds(node);
+}
+
+void ParetoArchive::insertInto(Node& node, int id)
+{
+    extendBounds(node, point(id));
+
+    if (node.isLeaf()) {
+        node.points.push_back(id);
+        if (node.points.size() > MaxLeafSize) {
+            split(node);
+        }
+        return;
+    }
+
+    Node* best = nullptr;
+    float best_distance = std::numeric_limits<float>::max();
+    for (auto& child : node.children) {
+        const float distance = distanceToCenter(*child, point(id));
+        if (!best || distance < best_distance) {
+            best = child.get();
+            best_distance = distance;
+        }
+    }
+    insertInto(*best, id);
+}
+
+void ParetoArchive::split(Node& node)
+{
+    const std::vector<int>& points = node.points;
+    const size_t n = points.size();
+    const size_t k = std::min(n, m_numObjectives + 1);
+
+    // Первый центр - самая удалённая от остальных точка, следующие - самые
+    // удалённые от уже выбранных центров
+    std::vector<int> seeds;
+    {
+        size_t first = 0;
+        float best_sum = -1.0f;
+        for (size_t a = 0; a < n; ++a) {
+            float sum = 0.0f;
+            for (size_t b = 0; b < n; ++b) {
+                sum += squaredDistance(point(points[a]), point(points[b]), m_numObjectives);
+            }
+            if (sum > best_sum) {
+                best_sum = sum;
+                first = a;
+            }
+        }
+        seeds.push_back(points[first]);
+    }
+    while (seeds.size() < k) {
+        int next = -1;
+        float best_min = -1.0f;
+        for (int id : points) {
+            if (std::find(seeds.begin(), seeds.end(), id) != seeds.end()) {
+                continue;
+            }
+            float min_distance = std::numeric_limits<float>::max();
+            for (int seed : seeds) {
+                min_distance = std::min(min_distance, squaredDistance(point(id), point(seed), m_numObjectives));
+            }
+            if (min_distance > best_min) {
+                best_min = min_distance;
+                next = id;
+            }
+        }
+        seeds.push_back(next);
+    }
+
+    std::vector<std::unique_ptr<Node>> children;
+    for (size_t c = 0; c < seeds.size(); ++c) {
+        children.emplace_back(new Node());
+    }
+    for (int id : points) {
+        size_t nearest = 0;
+        float nearest_distance = std::numeric_limits<float>::max();
+        for (size_t c = 0; c < seeds.size(); ++c) {
+            const float distance = squaredDistance(point(id), point(seeds[c]), m_numObjectives);
+            if (distance < nearest_distance) {
+                nearest_distance = distance;
+                nearest = c;
+            }
+        }
+        children[nearest]->points.push_back(id);
+    }
+    for (auto& child : children) {
+        updateBounds(*child);
+    }
+    children.erase(std::remove_if(children.begin(), children.end(),
+                                  [](const std::unique_ptr<Node>& child) { return child->isEmpty(); }),
+                   children.end());
+
+    node.points.clear();
+    node.children = std::move(children);
+}
+
+void ParetoArchive::releaseAll(Node& node)
+{
+    for (int id : node.points) {
+        m_alive[id] = 0;
+        m_entries[id] = ParetoArchiveEntry();
+        m_free.push_back(id);
+        --m_size;
+    }
+    for (auto& child : node.children) {
+        releaseAll(*child);
+    }
+    node.points.clear();
+    node.children.clear();
+}
+
+void ParetoArchive::updateBounds(Node& node) const
+{
+    node.ideal.clear();
+    node.nadir.clear();
+    if (node.isLeaf()) {
+        for (int id : node.points) {
+            extendBounds(node, point(id));
+        }
+        return;
+    }
+    for (const auto& child : node.children) {
+        extendBounds(node, child->ideal.data());
+        extendBounds(node, child->nadir.data());
+    }
+}
+
+void ParetoArchive::extendBounds(Node& node, const float* fitness) const
+{
+    if (node.ideal.empty()) {
+        node.ideal.assign(fitness, fitness + m_numObjectives);
+        node.nadir.assign(fitness, fitness + m_numObjectives);
+        return;
+    }
+    for (size_t j = 0; j < m_numObjectives; ++j) {
+        node.ideal[j] = std::min(node.ideal[j], fitness[j]);
+        node.nadir[j] = std::max(node.nadir[j], fitness[j]);
+    }
+}
+
+float ParetoArchive::distanceToCenter(const Node& node, const float* fitness) const
+{
+    float sum = 0.0f;
+    for (size_t j = 0; j < m_numObjectives; ++j) {
+        const float d = fitness[j] - 0.5f * (node.ideal[j] + node.nadir[j]);
+        sum += d * d;
+    }
+    return sum;
+}
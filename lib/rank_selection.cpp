@@ -0,0 +1,85 @@
+#include "rank_selection.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+std::vector<double> RankSelector::tournamentWeights(const std::vector<int>& ranks, int tournament_size)
+{
+    const size_t n = ranks.size();
+    std::vector<double> weights(n, 0.0);
+    if (n == 0) {
+        return weights;
+    }
+
+    // Ранг - число доминирующих особей, поэтому лежит в [0, N)
+    const int max_rank = *std::max_element(ranks.begin(), ranks.end());
+    std::vector<size_t> count(static_cast<size_t>(std::max(max_rank, 0)) + 2, 0);
+    for (int rank : ranks) {
+        ++count[std::max(rank, 0)];
+    }
+
+    // P(минимум турнира = r) делится поровну между особями ранга r
+    const int k = std::max(tournament_size, 1);
+    std::vector<double> per_individual(count.size(), 0.0);
+    size_t at_least = n;   // особей с рангом >= r
+    for (size_t r = 0; r < count.size() && at_least > 0; ++r) {
+        if (count[r] > 0) {
+            const size_t greater = at_least - count[r];
+            const double p = std::pow(static_cast<double>(at_least) / n, k) -
+                             std::pow(static_cast<double>(greater) / n, k);
+            per_individual[r] = p / static_cast<double>(count[r]);
+        }
+        at_least -= count[r];
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        weights[i] = per_individual[std::max(ranks[i], 0)];
+    }
+    return weights;
+}
+
+void RankSelector::build(const std::vector<int>& ranks, int tournament_size)
+{
+    const std::vector<double> weights = tournamentWeights(ranks, tournament_size);
+    const int n = static_cast<int>(weights.size());
+    m_probability.assign(n, 1.0f);
+    m_alias.resize(n);
+    if (n == 0) {
+        return;
+    }
+
+    double total = 0.0;
+    for (double w : weights) {
+        total += w;
+    }
+
+    // Метод Воуза: ячейки с долей < 1 дополняются из ячеек с долей > 1
+    std::vector<double> scaled(n);
+    std::vector<int> small;
+    std::vector<int> large;
+    for (int i = 0; i < n; ++i) {
+        scaled[i] = weights[i] * n / total;
+        m_alias[i] = i;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        const int s = small.back();
+        small.pop_back();
+        const int l = large.back();
+        m_probability[s] = static_cast<float>(scaled[s]);
+        m_alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // Остатки (погрешность округления) выбираются сами собой
+    for (int i : small) {
+        m_probability[i] = 1.0f;
+    }
+    for (int i : large) {
+        m_probability[i] = 1.0f;
+    }
+}
@@ -1,5 +1,94 @@
 #include "reader.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+
+namespace {
+
+// Ищет атрибут name="..." внутри тега [begin, end), возвращает начало значения
+const char* findAttribute(const char* begin, const char* end, const char* name)
+{
+	const size_t len = std::strlen(name);
+	const char* it = begin;
+	while (true)
+	{
+		it = std::search(it, end, name, name + len);
+		if (it == end)
+			return nullptr;
+		// имя атрибута должно начинаться после пробела и заканчиваться на ="
+		const char* after = it + len;
+		if (it > begin && (it[-1] == ' ' || it[-1] == '\t' || it[-1] == '\n' || it[-1] == '\r') &&
+			after + 1 < end && after[0] == '=' && after[1] == '"')
+			return after + 2;
+		it = after;
+	}
+}
+
+// Разбор целого значения атрибута, которое должно заканчиваться кавычкой
+bool parseIntAttribute(const char* value, int& out)
+{
+	if (value == nullptr)
+		return false;
+	char* endp = nullptr;
+	long v = std::strtol(value, &endp, 10);
+	if (endp == value || *endp != '"')
+		return false;
+	out = static_cast<int>(v);
+	return true;
+}
+
+bool parseFloatAttribute(const char* value, float& out)
+{
+	if (value == nullptr)
+		return false;
+	char* endp = nullptr;
+	float v = std::strtof(value, &endp);
+	if (endp == value || *endp != '"')
+		return false;
+	out = v;
+	return true;
+}
+
+// Обход тегов <cellN .../> после <cells cellcount="..."> за один проход
+template <typename CellHandler>
+bool forEachCell(const std::string& buffer, int& cellCount, CellHandler handler)
+{
+	const char* begin = buffer.data();
+	const char* end = begin + buffer.size();
+
+	const char cellsTag[] = "<cells";
+	const char* cells = std::search(begin, end, cellsTag, cellsTag + sizeof(cellsTag) - 1);
+	if (cells == end)
+		return false;
+	const char* cellsEnd = std::find(cells, end, '>');
+	if (cellsEnd == end || !parseIntAttribute(findAttribute(cells, cellsEnd, "cellcount"), cellCount))
+		return false;
+	// каждая ячейка занимает в файле больше байта: больший cellcount - испорченный файл
+	if (cellCount < 0 || static_cast<size_t>(cellCount) > buffer.size())
+		return false;
+
+	const char cellTag[] = "<cell";
+	const char* it = cellsEnd;
+	while (true)
+	{
+		it = std::search(it, end, cellTag, cellTag + sizeof(cellTag) - 1);
+		if (it == end)
+			return true;
+		const char* tagEnd = std::find(it, end, '>');
+		if (tagEnd == end)
+			return false;
+		// <cells ...> уже пройден, </cells> начинается с "</"
+		if (!handler(it, tagEnd))
+			return false;
+		it = tagEnd;
+	}
+}
+
+}
 
 
 NOPMatrixReader::NOPMatrixReader(const std::string& matrixPath, const std::string& paramsPath)
@@ -10,6 +99,108 @@ NOPMatrixReader::NOPMatrixReader(const std::string& matrixPath, const std::strin
 }
 
 void NOPMatrixReader::readMatrix(const std::string& matrixPath)
+{
+	if (!readMatrixStreaming(matrixPath))
+		readMatrixXml(matrixPath);
+}
+
+void NOPMatrixReader::readParams(const std::string& paramsPath)
+{
+	if (!readParamsStreaming(paramsPath))
+		readParamsXml(paramsPath);
+}
+
+bool NOPMatrixReader::loadFile(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	const std::streamsize size = file.tellg();
+	if (size <= 0)
+		return false;
+	file.seekg(0);
+
+	m_buffer.resize(static_cast<size_t>(size));
+	return static_cast<bool>(file.read(&m_buffer[0], size));
+}
+
+bool NOPMatrixReader::readMatrixStreaming(const std::string& matrixPath)
+{
+	if (!loadFile(matrixPath))
+		return false;
+
+	bool sized = false;
+	int cellCount = 0;
+	bool ok = forEachCell(m_buffer, cellCount, [&](const char* tag, const char* tagEnd)
+	{
+		if (!sized)
+		{
+			resizeMatrix(static_cast<int>(sqrt(cellCount)));
+			sized = true;
+		}
+
+		int column = 0, row = 0, value = 0;
+		if (!parseIntAttribute(findAttribute(tag, tagEnd, "column"), column) ||
+			!parseIntAttribute(findAttribute(tag, tagEnd, "row"), row))
+			return false;
+
+		if (column < 0 || row < 0 || column > m_size || row > m_size)
+			return false;
+		// skip first column 
+		if (column == 0 || row == 0)
+			return true;
+		if (!parseIntAttribute(findAttribute(tag, tagEnd, "text"), value))
+			return false;
+
+		m_matrix[row - 1][column - 1] = value;
+		return true;
+	});
+
+	if (ok && !sized)
+		resizeMatrix(static_cast<int>(sqrt(cellCount)));
+	return ok;
+}
+
+bool NOPMatrixReader::readParamsStreaming(const std::string& paramsPath)
+{
+	if (!loadFile(paramsPath))
+		return false;
+
+	bool sized = false;
+	int cellCount = 0;
+	bool ok = forEachCell(m_buffer, cellCount, [&](const char* tag, const char* tagEnd)
+	{
+		if (!sized)
+		{
+			m_params.assign(cellCount / 2, 0.0f);
+			sized = true;
+		}
+
+		int column = 0, row = 0;
+		float value = 0.0f;
+		if (!parseIntAttribute(findAttribute(tag, tagEnd, "column"), column) ||
+			!parseIntAttribute(findAttribute(tag, tagEnd, "row"), row))
+			return false;
+
+		if (column < 0 || row < 0 || row >= static_cast<int>(m_params.size()))
+			return false;
+		// первая колонка - имена параметров
+		if (column == 0)
+			return true;
+		if (!parseFloatAttribute(findAttribute(tag, tagEnd, "text"), value))
+			return false;
+
+		m_params[row] = value;
+		return true;
+	});
+
+	if (ok && !sized)
+		m_params.assign(cellCount / 2, 0.0f);
+	return ok;
+}
+
+void NOPMatrixReader::readMatrixXml(const std::string& matrixPath)
 {
 
 	ptree pt;
@@ -17,6 +208,8 @@ void NOPMatrixReader::readMatrix(const std::string& matrixPath)
 
 	auto contentData = pt.get_child("CONFIG.grid.content").front();
 	int sizeSquared = std::stoi(contentData.second.get("<xmlattr>.cellcount", ""));
+	if (sizeSquared < 0)
+		throw std::invalid_argument("NOPMatrixReader: negative cellcount in " + matrixPath);
 	int size = sqrt(sizeSquared);
 	
 	resizeMatrix(size);	
@@ -33,18 +226,22 @@ void NOPMatrixReader::readMatrix(const std::string& matrixPath)
 			int val = std::stoi(value);
 			int m = std::stoi(column) - 1;
 			int n = std::stoi(row) - 1;
+			if (m < 0 || n < 0 || m >= m_size || n >= m_size)
+				throw std::invalid_argument("NOPMatrixReader: cell outside the matrix in " + matrixPath);
 			m_matrix[n][m] = val;
 		}
 	}
 }
 
-void NOPMatrixReader::readParams(const std::string& paramsPath)
+void NOPMatrixReader::readParamsXml(const std::string& paramsPath)
 {
 	ptree pt;
 	read_xml(paramsPath, pt);
 	
 	auto contentData = pt.get_child("CONFIG.grid.content").front();
 	int size = std::stoi(contentData.second.get("<xmlattr>.cellcount", "")) / 2;
+	if (size < 0)
+		throw std::invalid_argument("NOPMatrixReader: negative cellcount in " + paramsPath);
 	m_params.resize(size);
 
 
@@ -58,6 +255,8 @@ void NOPMatrixReader::readParams(const std::string& paramsPath)
 		{
 			float val = std::stof(value);
 			int n = std::stoi(row);
+			if (n < 0 || n >= size)
+				throw std::invalid_argument("NOPMatrixReader: parameter row outside the list in " + paramsPath);
 			m_params[n] = val;
 		}
 	}
@@ -0,0 +1,566 @@
+#include "remote_evaluator.hpp"
+#include "nop.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace {
+
+constexpr uint32_t RemoteMagic = 0x57504F4Eu;          // "NOPW"
+constexpr uint32_t MaxPayloadSize = 256u * 1024u * 1024u;
+constexpr float FailedFitness = 1e9f;                   // как у evaluator'ов при исключении
+
+static_assert(sizeof(RemoteMessageHeader) == 16, "RemoteMessageHeader must be 16 bytes");
+
+
+/**
+ * @brief Решение, которое приходит уже декодированной сетью
+ */
+class NetOperSolution : public ISolution
+{
+public:
+    void decode(const std::vector<int>&, const std::vector<std::vector<int>>&) override {}
+
+    std::unique_ptr<ISolution> clone() const override
+    {
+        return std::make_unique<NetOperSolution>(*this);
+    }
+
+    std::vector<float> getParameters() const override
+    {
+        return const_cast<NetOper&>(m_net).get_parameters();
+    }
+
+    NetOper& getNetOper() override { return m_net; }
+    const NetOper& getNetOperConst() const override { return m_net; }
+
+private:
+    NetOper m_net;
+};
+
+
+struct SocketAddress
+{
+    sockaddr_storage storage{};
+    socklen_t length = 0;
+    int family = AF_UNSPEC;
+    std::string unixPath;
+};
+
+bool parseEndpoint(const std::string& endpoint, SocketAddress& address)
+{
+    if (endpoint.compare(0, 5, "unix:") == 0) {
+        const std::string path = endpoint.substr(5);
+        sockaddr_un* un = reinterpret_cast<sockaddr_un*>(&address.storage);
+        if (path.empty() || path.size() >= sizeof(un->sun_path))
+            return false;
+        un->sun_family = AF_UNIX;
+        std::memcpy(un->sun_path, path.c_str(), path.size() + 1);
+        address.length = sizeof(sockaddr_un);
+        address.family = AF_UNIX;
+        address.unixPath = path;
+        return true;
+    }
+
+    if (endpoint.compare(0, 4, "tcp:") == 0) {
+        const std::string hostPort = endpoint.substr(4);
+        const size_t colon = hostPort.rfind(':');
+        if (colon == std::string::npos)
+            return false;
+        const std::string host = hostPort.substr(0, colon);
+        const std::string port = hostPort.substr(colon + 1);
+
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = host.empty() ? AI_PASSIVE : 0;
+        addrinfo* info = nullptr;
+        if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &info) != 0 || !info)
+            return false;
+        std::memcpy(&address.storage, info->ai_addr, info->ai_addrlen);
+        address.length = info->ai_addrlen;
+        address.family = AF_INET;
+        freeaddrinfo(info);
+        return true;
+    }
+
+    return false;
+}
+
+void setReceiveTimeout(int fd, int timeout_ms)
+{
+    timeval tv{};
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+bool sendAll(int fd, const char* data, size_t size)
+{
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool recvAll(int fd, char* data, size_t size)
+{
+    while (size > 0) {
+        ssize_t n = recv(fd, data, size, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool sendMessage(int fd, uint32_t type, uint32_t batch_id, const std::vector<char>& payload)
+{
+    RemoteMessageHeader header{RemoteMagic, type, batch_id, static_cast<uint32_t>(payload.size())};
+    return sendAll(fd, reinterpret_cast<const char*>(&header), sizeof(header)) &&
+           sendAll(fd, payload.data(), payload.size());
+}
+
+bool recvMessage(int fd, RemoteMessageHeader& header, std::vector<char>& payload)
+{
+    if (!recvAll(fd, reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+    if (header.magic != RemoteMagic || header.size > MaxPayloadSize)
+        return false;
+    payload.resize(header.size);
+    return recvAll(fd, payload.data(), payload.size());
+}
+
+template <typename T>
+void appendRaw(std::vector<char>& out, const T& value)
+{
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool readRaw(const char*& it, const char* end, T& value)
+{
+    if (static_cast<size_t>(end - it) < sizeof(T))
+        return false;
+    std::memcpy(&value, it, sizeof(T));
+    it += sizeof(T);
+    return true;
+}
+
+}
+
+
+RemoteFitnessEvaluator::RemoteFitnessEvaluator(const RemoteEvaluatorConfig& config,
+                                               std::shared_ptr<IFitnessEvaluator> local)
+    : m_config(config), m_local(std::move(local))
+{
+    if (!m_local) {
+        throw std::invalid_argument("RemoteFitnessEvaluator needs a local evaluator");
+    }
+    if (m_config.batch_size <= 0) {
+        throw std::invalid_argument("batch_size must be > 0");
+    }
+
+    SocketAddress address;
+    if (!parseEndpoint(m_config.endpoint, address)) {
+        throw std::invalid_argument("Invalid evaluator endpoint: " + m_config.endpoint);
+    }
+
+    m_listenFd = socket(address.family, SOCK_STREAM, 0);
+    if (m_listenFd < 0) {
+        throw std::runtime_error("Could not create socket for " + m_config.endpoint);
+    }
+
+    if (address.family == AF_UNIX) {
+        unlink(address.unixPath.c_str());
+        m_unixPath = address.unixPath;
+    } else {
+        int reuse = 1;
+        setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    }
+
+    if (bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0 ||
+        listen(m_listenFd, 64) != 0) {
+        close(m_listenFd);
+        m_listenFd = -1;
+        throw std::runtime_error("Could not listen on " + m_config.endpoint + ": " + std::strerror(errno));
+    }
+
+    std::cout << "Waiting for evaluation workers on " << m_config.endpoint << std::endl;
+}
+
+RemoteFitnessEvaluator::~RemoteFitnessEvaluator()
+{
+    for (int fd : m_idle) {
+        sendMessage(fd, RemoteShutdown, 0, {});
+        close(fd);
+    }
+    if (m_listenFd >= 0) {
+        close(m_listenFd);
+    }
+    if (!m_unixPath.empty()) {
+        unlink(m_unixPath.c_str());
+    }
+}
+
+std::vector<float> RemoteFitnessEvaluator::evaluate(const ISolution& solution)
+{
+    return evaluateBatch({&solution}).front();
+}
+
+std::vector<std::vector<float>> RemoteFitnessEvaluator::evaluateBatch(const std::vector<const ISolution*>& solutions)
+{
+    const size_t count = solutions.size();
+    const int num_obj = getNumObjectives();
+    std::vector<std::vector<float>> results(count);
+    if (count == 0) {
+        return results;
+    }
+
+    // Пакет делится поровну между свободными worker'ами, но не больше batch_size сетей на worker'а
+    size_t batch_size = static_cast<size_t>(m_config.batch_size);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (acceptWorker()) {}
+        const size_t idle = std::max<size_t>(1, m_idle.size());
+        batch_size = std::min(batch_size, (count + idle - 1) / idle);
+    }
+    const size_t num_chunks = (count + batch_size - 1) / batch_size;
+    std::deque<size_t> pending;
+    for (size_t c = 0; c < num_chunks; ++c) {
+        pending.push_back(c);
+    }
+
+    auto chunkRange = [&](size_t chunk, size_t& begin, size_t& end) {
+        begin = chunk * batch_size;
+        end = std::min(count, begin + batch_size);
+    };
+
+    size_t done = 0;
+    std::vector<Worker> leased;
+    std::vector<char> payload;
+    std::vector<char> image;
+
+    while (done < num_chunks) {
+        // Аренда: новые подключения и свободные worker'ы пула, по одному на ожидающий пакет
+        bool evaluate_locally = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (acceptWorker()) {}
+            size_t idle_leased = std::count_if(leased.begin(), leased.end(),
+                                               [](const Worker& w) { return !w.busy; });
+            while (!m_idle.empty() && idle_leased < pending.size()) {
+                Worker worker;
+                worker.fd = m_idle.back();
+                m_idle.pop_back();
+                leased.push_back(worker);
+                ++idle_leased;
+            }
+            if (leased.empty()) {
+                if (m_numWorkers.load() > 0) {
+                    // Все worker'ы заняты другими вызовами - ждём возврата или нового подключения
+                    m_workerReturned.wait_for(lock, std::chrono::milliseconds(100));
+                    continue;
+                }
+                evaluate_locally = true;
+            }
+        }
+
+        // Без worker'ов оцениваем сами, чтобы запуск не зависал
+        if (evaluate_locally) {
+            const size_t chunk = pending.front();
+            pending.pop_front();
+            size_t begin, end;
+            chunkRange(chunk, begin, end);
+            std::vector<const ISolution*> local(solutions.begin() + begin, solutions.begin() + end);
+            auto local_results = m_local->evaluateBatch(local);
+            std::move(local_results.begin(), local_results.end(), results.begin() + begin);
+            ++done;
+            continue;
+        }
+
+        // Свободным арендованным worker'ам - следующие пакеты
+        for (auto& worker : leased) {
+            if (worker.busy || pending.empty()) {
+                continue;
+            }
+            const size_t chunk = pending.front();
+            size_t begin, end;
+            chunkRange(chunk, begin, end);
+
+            payload.clear();
+            appendRaw(payload, static_cast<uint32_t>(end - begin));
+            for (size_t i = begin; i < end; ++i) {
+                solutions[i]->getNetOperConst().toBinary(image);
+                appendRaw(payload, static_cast<uint32_t>(image.size()));
+                payload.insert(payload.end(), image.begin(), image.end());
+            }
+
+            worker.batch_id = m_nextBatchId.fetch_add(1);
+            if (!sendMessage(worker.fd, RemoteEvaluate, worker.batch_id, payload)) {
+                std::cerr << "WARNING: Evaluation worker disconnected" << std::endl;
+                dropWorker(worker, pending);
+                continue;
+            }
+            pending.pop_front();
+            worker.busy = true;
+            worker.chunk = chunk;
+            worker.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_config.timeout_ms);
+        }
+
+        // Ждём ответов арендованных worker'ов или ближайшего таймаута
+        std::vector<pollfd> fds;
+        auto now = std::chrono::steady_clock::now();
+        int wait_ms = 100;
+        for (const auto& worker : leased) {
+            fds.push_back(pollfd{worker.fd, static_cast<short>(worker.fd >= 0 ? POLLIN : 0), 0});
+            if (worker.busy) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(worker.deadline - now).count();
+                wait_ms = std::max(0, std::min(wait_ms, static_cast<int>(left)));
+            }
+        }
+        poll(fds.data(), fds.size(), wait_ms);
+
+        now = std::chrono::steady_clock::now();
+        for (size_t w = 0; w < leased.size(); ++w) {
+            Worker& worker = leased[w];
+            const short revents = fds[w].revents;
+            if (worker.fd < 0) {
+                continue;
+            }
+
+            if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                RemoteMessageHeader header{};
+                std::vector<char> reply;
+                if (!worker.busy || !recvMessage(worker.fd, header, reply) ||
+                    header.type != RemoteResult || header.batch_id != worker.batch_id) {
+                    std::cerr << "WARNING: Evaluation worker disconnected, re-dispatching its batch" << std::endl;
+                    dropWorker(worker, pending);
+                    continue;
+                }
+
+                size_t begin, end;
+                chunkRange(worker.chunk, begin, end);
+                const char* it = reply.data();
+                const char* reply_end = reply.data() + reply.size();
+                uint32_t reply_count = 0, reply_obj = 0;
+                if (!readRaw(it, reply_end, reply_count) || !readRaw(it, reply_end, reply_obj) ||
+                    reply_count != end - begin || reply_obj != static_cast<uint32_t>(num_obj) ||
+                    static_cast<size_t>(reply_end - it) != reply_count * reply_obj * sizeof(float)) {
+                    std::cerr << "WARNING: Malformed result from evaluation worker" << std::endl;
+                    dropWorker(worker, pending);
+                    continue;
+                }
+                for (size_t i = begin; i < end; ++i) {
+                    results[i].resize(num_obj);
+                    std::memcpy(results[i].data(), it, num_obj * sizeof(float));
+                    it += num_obj * sizeof(float);
+                }
+                worker.busy = false;
+                ++done;
+            } else if (worker.busy && now >= worker.deadline) {
+                std::cerr << "WARNING: Evaluation worker timed out, re-dispatching its batch" << std::endl;
+                dropWorker(worker, pending);
+            }
+        }
+
+        // Отключённые выбрасываются, свободные без пакетов возвращаются в пул
+        bool returned = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto keep = std::remove_if(leased.begin(), leased.end(), [&](const Worker& w) {
+                if (w.fd < 0) {
+                    return true;
+                }
+                if (!w.busy && pending.empty()) {
+                    m_idle.push_back(w.fd);
+                    returned = true;
+                    return true;
+                }
+                return false;
+            });
+            leased.erase(keep, leased.end());
+        }
+        if (returned) {
+            m_workerReturned.notify_all();
+        }
+    }
+
+    return results;
+}
+
+int RemoteFitnessEvaluator::getNumObjectives() const
+{
+    return m_local->getNumObjectives();
+}
+
+uint64_t RemoteFitnessEvaluator::getConfigHash() const
+{
+    return m_local->getConfigHash();
+}
+
+int RemoteFitnessEvaluator::numWorkers() const
+{
+    return m_numWorkers.load();
+}
+
+bool RemoteFitnessEvaluator::acceptWorker()
+{
+    pollfd pfd{m_listenFd, POLLIN, 0};
+    if (poll(&pfd, 1, 0) <= 0 || !(pfd.revents & POLLIN)) {
+        return false;
+    }
+
+    int fd = accept(m_listenFd, nullptr, nullptr);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Зависший посреди сообщения worker не должен блокировать master дольше таймаута
+    setReceiveTimeout(fd, m_config.timeout_ms);
+
+    RemoteMessageHeader header{};
+    std::vector<char> payload;
+    int32_t num_obj = 0;
+    uint64_t config_hash = 0;
+    bool hello = recvMessage(fd, header, payload) && header.type == RemoteHello;
+    if (hello) {
+        const char* it = payload.data();
+        const char* end = payload.data() + payload.size();
+        hello = readRaw(it, end, num_obj) && readRaw(it, end, config_hash);
+    }
+    if (!hello) {
+        std::cerr << "WARNING: Rejected evaluation worker: bad handshake" << std::endl;
+        close(fd);
+        return true;
+    }
+
+    const uint64_t expected_hash = getConfigHash();
+    if (num_obj != getNumObjectives() || (expected_hash != 0 && config_hash != expected_hash)) {
+        std::cerr << "WARNING: Rejected evaluation worker: different evaluator configuration" << std::endl;
+        sendMessage(fd, RemoteShutdown, 0, {});
+        close(fd);
+        return true;
+    }
+
+    m_idle.push_back(fd);
+    const int total = ++m_numWorkers;
+    std::cout << "Evaluation worker connected (" << total << " total)" << std::endl;
+    m_workerReturned.notify_all();
+    return true;
+}
+
+void RemoteFitnessEvaluator::dropWorker(Worker& worker, std::deque<size_t>& pending)
+{
+    if (worker.busy) {
+        pending.push_front(worker.chunk);
+    }
+    if (worker.fd >= 0) {
+        close(worker.fd);
+        --m_numWorkers;
+    }
+    worker.fd = -1;
+    worker.busy = false;
+}
+
+
+long runEvaluationWorker(const std::string& endpoint, IFitnessEvaluator& evaluator)
+{
+    SocketAddress address;
+    if (!parseEndpoint(endpoint, address)) {
+        std::cerr << "ERROR: Invalid evaluator endpoint: " << endpoint << std::endl;
+        return -1;
+    }
+
+    int fd = socket(address.family, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0) {
+        std::cerr << "ERROR: Could not connect to " << endpoint << std::endl;
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+
+    const int num_obj = evaluator.getNumObjectives();
+    std::vector<char> payload;
+    appendRaw(payload, static_cast<int32_t>(num_obj));
+    appendRaw(payload, evaluator.getConfigHash());
+    if (!sendMessage(fd, RemoteHello, 0, payload)) {
+        close(fd);
+        return -1;
+    }
+
+    long evaluated = 0;
+    RemoteMessageHeader header{};
+    std::vector<NetOperSolution> solutions;
+    while (recvMessage(fd, header, payload)) {
+        if (header.type == RemoteShutdown)
+            break;
+        if (header.type != RemoteEvaluate)
+            continue;
+
+        const char* it = payload.data();
+        const char* end = payload.data() + payload.size();
+        uint32_t count = 0;
+        if (!readRaw(it, end, count))
+            break;
+
+        // Сети декодируются в переиспользуемые решения, оцениваются одним пакетом
+        if (solutions.size() < count)
+            solutions.resize(count);
+        std::vector<const ISolution*> batch;
+        std::vector<char> valid(count, 0);
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t size = 0;
+            if (!readRaw(it, end, size) || static_cast<size_t>(end - it) < size)
+                break;
+            valid[i] = solutions[i].getNetOper().fromBinary(it, size);
+            it += size;
+            if (valid[i])
+                batch.push_back(&solutions[i]);
+        }
+
+        auto fitness = evaluator.evaluateBatch(batch);
+
+        std::vector<char> reply;
+        appendRaw(reply, count);
+        appendRaw(reply, static_cast<uint32_t>(num_obj));
+        size_t k = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            for (int j = 0; j < num_obj; ++j) {
+                float value = FailedFitness;
+                if (valid[i] && k < fitness.size() && j < static_cast<int>(fitness[k].size()))
+                    value = fitness[k][j];
+                appendRaw(reply, value);
+            }
+            if (valid[i])
+                ++k;
+        }
+
+        if (!sendMessage(fd, RemoteResult, header.batch_id, reply))
+            break;
+        evaluated += count;
+    }
+
+    close(fd);
+    return evaluated;
+}
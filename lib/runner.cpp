@@ -1,75 +1,199 @@
 #include "runner.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 
 Runner::Runner(Model& model, Controller& controller): 
     m_model(model),
-    m_controller(controller) 
+    m_controller(controller),
+    m_integrator(makeIntegrator(IntegrationMethod::Euler)),
+    m_baseDt(model.getDt()),
+    m_lastDt(model.getDt())
     { }
 
 void Runner::setGoal(const Model::State &goal)
 {
     m_controller.setGoal(goal);
+    m_hasControl = false;
 }
 
 void Runner::init(const Model::State& state)
 {
     m_model.setState(state);
     m_model.setVelocity(0.0, 0.0);
+    m_model.setDt(m_baseDt);
+    m_stepMultiple = 1;
+    m_hasControl = false;
 }
 
-// TODO MB ERROR
-// void Runner::Euler2() 
-// {
-//     constexpr float K = 0.5;
-
-//     Model::State initialState = m_model.getState();
+void Runner::setIntegrator(std::unique_ptr<Integrator> integrator)
+{
+    if (!integrator) return;
+    m_integrator = std::move(integrator);
+}
 
-//     Model::Control u1 = m_controller.calcControl(initialState);
-//     Model::State v1 = // m_model.velocityFromControl(u1); // fa
-//     Model::State s1 = m_model.nextNNStateFromControl(u1); // m_model.nextStateFromVelocity(v1); // moved state
+Integrator& Runner::integrator()
+{
+    return *m_integrator;
+}
 
-//     Model::Control u2 = m_controller.calcControl(s1);
-//     m_model.setState(s1);
-//     Model::State v2 = m_model.velocityFromControl(u2); // fb
-//     m_model.setState(initialState);
-//     Model::State ctrl = (v1 + v2) * K;
-//     // TODO TEST ONLY
-//     Model::State nextState = m_model.nextNNStateFromControl(ctrl); // m_model.nextStateFromVelocity(ctrl);
-//     // Model::State nextState = m_model.nextStateFromControl(ctrl);
+void Runner::setAdaptiveStepping(const AdaptiveStepping& adaptive)
+{
+    m_adaptive = adaptive;
+    m_adaptive.max_step_multiple = std::max(1, m_adaptive.max_step_multiple);
+    m_model.setDt(m_baseDt);
+    m_stepMultiple = 1;
+    m_hasControl = false;
+}
 
-//     m_model.setState(nextState);
-// }
+float Runner::lastStepDt() const
+{
+    return m_lastDt;
+}
 
-void Runner::Euler2() 
+Model::State Runner::makeStep() 
 {
-    constexpr float K = 0.5f;
+    if (m_adaptive.enabled)
+        return makeAdaptiveStep();
+
+    Model::State next_state = m_integrator->step(m_model, m_controller);
+    m_model.setState(next_state);
+    m_lastDt = m_model.getDt();
+    return m_model.getState(); 
+}
 
-    Model::State initialState = m_model.getState();
+Model::State Runner::makeAdaptiveStep()
+{
+    const Model::State s0 = m_model.getState();
+    const float v0 = m_model.m_v;
+    const float w0 = m_model.m_w;
+
+    if (!m_hasControl)
+    {
+        m_control = m_controller.calcControl(s0);
+        m_hasControl = true;
+    }
+
+    // у цели шаг линейно уменьшается до базового
+    int multiple = m_stepMultiple;
+    const float goalDist = s0.distXY(m_controller.goal());
+    if (goalDist < m_adaptive.slow_radius)
+    {
+        const float k = goalDist / m_adaptive.slow_radius;
+        const int cap = 1 + static_cast<int>(k * (m_adaptive.max_step_multiple - 1));
+        multiple = std::min(multiple, cap);
+    }
+
+    while (true)
+    {
+        const float h = m_baseDt * multiple;
+        m_model.setDt(h);
+        // управление в s0 уже известно: контроллер вызывается один раз на попытку (в s1)
+        Model::State s1 = m_integrator->step(m_model, m_controller, m_control);
+
+        // оценка ошибки: насколько удержание управления на шаге отличается от
+        // управления в конце шага и насколько робот повернул за шаг
+        Model::Control u1 = m_controller.calcControl(s1);
+        const float du = std::max(std::fabs(u1.left - m_control.left),
+                                  std::fabs(u1.right - m_control.right));
+        const float turn = std::fabs(s1.yaw - s0.yaw);
+        const float err = std::max(du / m_adaptive.control_tolerance,
+                                   turn / m_adaptive.max_turn);
+
+        if (err <= 1.0f || multiple == 1)
+        {
+            m_model.setState(s1);
+            m_lastDt = h;
+            m_control = u1;
+
+            // схема первого порядка: новый шаг ~ h * err^(-1/2)
+            if (err < 0.25f)
+                m_stepMultiple = std::min(multiple * 2, m_adaptive.max_step_multiple);
+            else if (err > 1.0f)
+                m_stepMultiple = 1;
+            else
+                m_stepMultiple = multiple;
+            return s1;
+        }
+
+        // шаг отклонён: откатываем модель и уменьшаем шаг
+        m_model.setState(s0);
+        m_model.setVelocity(v0, w0);
+        multiple = std::max(1, multiple / 2);
+    }
+}
 
-    // 1. Считаем первый контроль
-    Model::Control u1 = m_controller.calcControl(initialState);
 
-    // 2. NN предсказывает новое состояние (s1) при u1
-    Model::State s1 = m_model.nextNNStateFromControl(u1);
+DivergenceMonitor::DivergenceMonitor(const DivergenceGuard& guard):
+    m_guard(guard)
+    { }
 
-    // // 3. Считаем второй контроль в промежуточной точке
-    // Model::Control u2 = m_controller.calcControl(s1);
+void DivergenceMonitor::reset()
+{
+    m_saturatedSteps = 0;
+    m_saturatedSigns = 0;
+}
 
-    // // 4. NN предсказывает новое состояние при u2
-    // Model::State s2 = m_model.nextNNStateFromControl(u2);
+bool DivergenceMonitor::diverged(const Model::State& state, const Model::Control& rawControl)
+{
+    if (!m_guard.enabled)
+        return false;
+
+    if (!std::isfinite(state.x) || !std::isfinite(state.y) || !std::isfinite(state.yaw) ||
+        !std::isfinite(rawControl.left) || !std::isfinite(rawControl.right))
+        return true;
+
+    if (m_guard.saturation_steps <= 0)
+        return false;
+
+    const bool saturated = std::fabs(rawControl.left) >= m_guard.saturation_level &&
+                           std::fabs(rawControl.right) >= m_guard.saturation_level;
+    if (!saturated)
+    {
+        m_saturatedSteps = 0;
+        return false;
+    }
+
+    // знаки обоих колёс: при смене направления счёт начинается заново
+    const int signs = (rawControl.left > 0.0f ? 1 : 0) | (rawControl.right > 0.0f ? 2 : 0);
+    if (m_saturatedSteps == 0 || signs != m_saturatedSigns)
+    {
+        m_saturatedSigns = signs;
+        m_saturatedSteps = 0;
+    }
+    return ++m_saturatedSteps >= m_guard.saturation_steps;
+}
 
-    // // 5. Усредняем (как RK2 / Heun)
-    // auto avg = (s1 + s2);
-    // avg = avg * K;
-    // auto next_state = m_model.nextStateFromVelocity(avg);
-    auto next_state = s1;
-    m_model.setState(next_state);
+void RolloutCost::reset(const Model::State& init)
+{
+    time = 0.0f;
+    path = 0.0f;
+    smoothness = 0.0f;
+    last = init;
+    velocity = Model::State{0.0f, 0.0f, 0.0f};
 }
 
+void RolloutCost::addStep(const Model::State& state, float dt)
+{
+    const float dx = state.x - last.x;
+    const float dy = state.y - last.y;
+    path += std::sqrt(dx * dx + dy * dy);
+
+    const float vx = dx / dt;
+    const float vy = dy / dt;
+    const float ax = (vx - velocity.x) / dt;
+    const float ay = (vy - velocity.y) / dt;
+    smoothness += std::sqrt(ax * ax + ay * ay) * 0.1f;
+
+    last = state;
+    velocity = Model::State{vx, vy, 0.0f};
+    time += dt;
+}
 
-Model::State Runner::makeStep() 
+void RolloutCost::chargeCut(const DivergenceGuard& guard, float timeLimit)
 {
-    Euler2();
-    // std::cout<<m_model.m_v<<"  "<<m_model.m_w<<std::endl;
-    return m_model.getState(); 
+    time = std::max(time, timeLimit);
+    path = std::max(path, guard.cut_path);
+    smoothness = std::max(smoothness, guard.cut_smoothness);
 }
@@ -0,0 +1,184 @@
+#include "trajectory_writer.hpp"
+
+#include <cstring>
+#include <iostream>
+
+
+namespace {
+
+constexpr char TrajectoryMagic[8] = {'N', 'O', 'P', 'T', 'R', 'A', 'J', '\0'};
+
+}
+
+constexpr uint32_t TrajectoryWriter::Version;
+constexpr uint32_t TrajectoryWriter::NumColumns;
+
+
+TrajectoryWriter::TrajectoryWriter(size_t bufferSize):
+    m_buffer(bufferSize)
+    { }
+
+TrajectoryWriter::~TrajectoryWriter()
+{
+    close();
+}
+
+bool TrajectoryWriter::open(const std::string& filepath)
+{
+    close();
+
+    // буфер потока должен быть установлен до открытия файла
+    if (!m_buffer.empty())
+        m_file.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+
+    m_file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        std::cerr << "ERROR: Could not open trajectory file for writing: " << filepath << std::endl;
+        return false;
+    }
+
+    // заголовок перезаписывается в close(), когда известен индекс
+    TrajectoryFileHeader header{};
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_offset = sizeof(header);
+    m_index.clear();
+    m_inTrajectory = false;
+    return true;
+}
+
+void TrajectoryWriter::beginTrajectory()
+{
+    if (m_inTrajectory)
+        endTrajectory();
+
+    for (auto& column : m_columns)
+        column.clear();
+    m_inTrajectory = true;
+}
+
+void TrajectoryWriter::addSample(float time, const Model::State& state)
+{
+    m_columns[0].push_back(time);
+    m_columns[1].push_back(state.x);
+    m_columns[2].push_back(state.y);
+    m_columns[3].push_back(state.yaw);
+}
+
+void TrajectoryWriter::endTrajectory()
+{
+    if (!m_inTrajectory || !m_file.is_open())
+        return;
+
+    const uint64_t numSamples = m_columns[0].size();
+    m_index.push_back(m_offset);
+    m_index.push_back(numSamples);
+
+    for (const auto& column : m_columns) {
+        m_file.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(float));
+        m_offset += column.size() * sizeof(float);
+    }
+    m_inTrajectory = false;
+}
+
+bool TrajectoryWriter::close()
+{
+    if (!m_file.is_open())
+        return false;
+
+    endTrajectory();
+
+    // выравнивание таблицы индекса на 8 байт для np.memmap(dtype='<u8')
+    const char padding[8] = {0};
+    const uint64_t pad = (8 - m_offset % 8) % 8;
+    m_file.write(padding, pad);
+    m_offset += pad;
+
+    TrajectoryFileHeader header{};
+    std::memcpy(header.magic, TrajectoryMagic, sizeof(header.magic));
+    header.version = Version;
+    header.num_columns = NumColumns;
+    header.num_trajectories = m_index.size() / 2;
+    header.index_offset = m_offset;
+
+    m_file.write(reinterpret_cast<const char*>(m_index.data()), m_index.size() * sizeof(uint64_t));
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const bool ok = m_file.good();
+    m_file.close();
+    if (!ok)
+        std::cerr << "ERROR: Failed to write trajectory file" << std::endl;
+    return ok;
+}
+
+size_t TrajectoryWriter::numTrajectories() const
+{
+    return m_index.size() / 2;
+}
+
+
+bool readTrajectoryFile(const std::string& filepath, std::vector<std::vector<float>>& trajectories)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open trajectory file: " << filepath << std::endl;
+        return false;
+    }
+
+    TrajectoryFileHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, TrajectoryMagic, sizeof(header.magic)) != 0) {
+        std::cerr << "ERROR: Not a trajectory file: " << filepath << std::endl;
+        return false;
+    }
+    if (header.version != TrajectoryWriter::Version) {
+        std::cerr << "ERROR: Unsupported trajectory file version " << header.version << std::endl;
+        return false;
+    }
+
+    std::vector<uint64_t> index(header.num_trajectories * 2);
+    file.seekg(header.index_offset);
+    file.read(reinterpret_cast<char*>(index.data()), index.size() * sizeof(uint64_t));
+    if (!file) {
+        std::cerr << "ERROR: Trajectory file index is truncated: " << filepath << std::endl;
+        return false;
+    }
+
+    trajectories.assign(header.num_trajectories, {});
+    for (size_t i = 0; i < header.num_trajectories; ++i) {
+        auto& traj = trajectories[i];
+        traj.resize(index[2 * i + 1] * header.num_columns);
+        file.seekg(index[2 * i]);
+        file.read(reinterpret_cast<char*>(traj.data()), traj.size() * sizeof(float));
+        if (!file) {
+            std::cerr << "ERROR: Trajectory " << i << " is truncated in " << filepath << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool exportTrajectoriesToCsv(const std::string& binPath, const std::string& csvPath)
+{
+    std::vector<std::vector<float>> trajectories;
+    if (!readTrajectoryFile(binPath, trajectories))
+        return false;
+
+    std::ofstream out(csvPath);
+    if (!out.is_open()) {
+        std::cerr << "ERROR: Could not open " << csvPath << " for writing" << std::endl;
+        return false;
+    }
+
+    out << "Trajectory,Time,X,Y,Theta\n";
+    for (size_t i = 0; i < trajectories.size(); ++i) {
+        const auto& traj = trajectories[i];
+        const size_t n = traj.size() / TrajectoryWriter::NumColumns;
+        for (size_t k = 0; k < n; ++k) {
+            out << i << "," << traj[k] << ","
+                << traj[n + k] << "," << traj[2 * n + k] << ","
+                << traj[3 * n + k] << "\n";
+        }
+    }
+    return out.good();
+}
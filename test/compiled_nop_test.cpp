@@ -0,0 +1,105 @@
+#include "compiled_nop.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+NetOper makeReferenceNet() {
+    NetOper net;
+    net.setNodesForVars({0, 1, 2});
+    net.setNodesForParams({3, 4, 5});
+    net.setNodesForOutput({22, 23});
+    net.setCs(qc);
+    net.setPsi(NopPsiN);
+    return net;
+}
+
+}  // namespace
+
+TEST(CompiledNetOper, LiteralAndOptimizedMatchInterpreter) {
+    NetOper net = makeReferenceNet();
+    CompiledNetOper program(net);
+    EXPECT_TRUE(verifyCompiled(net, program));
+
+    const size_t literal = program.size();
+    const PeepholeStats stats = program.optimize();
+    EXPECT_EQ(stats.instructions_before, literal);
+    EXPECT_EQ(stats.instructions_after, program.size());
+    EXPECT_LT(program.size(), literal);
+    EXPECT_TRUE(verifyCompiled(net, program, 1000, 5.0f));
+    EXPECT_TRUE(verifyCompiled(net, program, 1000, 1e4f, 7));
+}
+
+TEST(CompiledNetOper, PeepholeRules) {
+    // y0 = -(-x0), y1 = ro_10(ro_10(x0 + x1)); узел 4 = c * 2 сворачивается, узел 7 = atan(x1) не на выходе
+    NetOper net;
+    net.setNodesForVars({0, 1});
+    net.setNodesForParams({2});
+    net.setNodesForOutput({5, 9});
+    net.setCs({3.0f});
+    net.setPsi({
+        {0, 0, 0, 3, 0, 0, 1, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 1, 13, 0, 0},
+        {0, 0, 0, 0, 21, 0, 0, 0, 0, 0},
+        {0, 0, 0, 1, 0, 3, 0, 0, 0, 0},
+        {0, 0, 0, 0, 2, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 1, 0, 10, 0},
+        {0, 0, 0, 0, 0, 0, 0, 1, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0, 1, 10},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
+    });
+    CompiledNetOper program(net);
+    const PeepholeStats stats = program.optimize();
+    EXPECT_TRUE(verifyCompiled(net, program));
+
+    // Остаются x0 + x1 и ro_10(x0 + x1), первый выход - сам вход x0
+    EXPECT_EQ(program.size(), 2u);
+    EXPECT_EQ(stats.involutions, 2u);
+    EXPECT_EQ(stats.folded, 2u);
+    EXPECT_EQ(stats.dead, 2u);   // atan(x1) и -x0 после сокращения -(-x0)
+    EXPECT_GE(stats.identities, 4u);
+    ASSERT_EQ(program.outputs().size(), 2u);
+    EXPECT_EQ(program.outputs()[0], static_cast<int>(program.constants().size()));
+}
+
+TEST(CompiledNetOper, CommonSubexpressionsMerged) {
+    // Оба выхода - ro_13(x0 + x1), собранные в разных узлах
+    NetOper net;
+    net.setNodesForVars({0, 1});
+    net.setNodesForOutput({4, 5});
+    net.setPsi({
+        {0, 0, 1, 1, 0, 0},
+        {0, 0, 1, 1, 0, 0},
+        {0, 0, 1, 0, 13, 0},
+        {0, 0, 0, 1, 0, 13},
+        {0, 0, 0, 0, 1, 0},
+        {0, 0, 0, 0, 0, 1},
+    });
+    CompiledNetOper program(net);
+    const PeepholeStats stats = program.optimize();
+    EXPECT_TRUE(verifyCompiled(net, program));
+    EXPECT_EQ(program.size(), 2u);
+    EXPECT_GE(stats.merged, 2u);
+    EXPECT_EQ(program.outputs()[0], program.outputs()[1]);
+}
+
+TEST(CompiledNetOper, VerifierDetectsStaleProgram) {
+    NetOper net = makeReferenceNet();
+    CompiledNetOper program(net);
+    program.optimize();
+
+    // Программа собрана по старой матрице: выход 22 теперь другой
+    auto psi = NopPsiN;
+    psi[0][22] = psi[0][22] == 12 ? 11 : 12;
+    net.setPsi(psi);
+    EXPECT_FALSE(verifyCompiled(net, program));
+}
+
+TEST(CompiledNetOper, UnknownOperationThrows) {
+    NetOper net;
+    net.setNodesForVars({0});
+    net.setNodesForOutput({1});
+    net.setPsi({{0, 42}, {0, 1}});
+    EXPECT_THROW(CompiledNetOper program(net), std::invalid_argument);
+}
@@ -1,6 +1,7 @@
 #include "controller.hpp"
 
 #include <gtest/gtest.h>
+#include <stdexcept>
 
 
 
@@ -50,4 +51,74 @@ TEST(Controller, SimpleTest)
     auto expectedResult = desiredFunction(x_in, parameters);    
 
     EXPECT_TRUE(abs(u.left - expectedResult) < 0.001);
-}
\ No newline at end of file
+}
+namespace {
+
+/// u = dx + c: дуги 0 -> 4 и 3 -> 4, узел 4 суммирует
+NetOper makeShiftNet(float c)
+{
+    NetOper net;
+    net.setNodesForVars({0, 1, 2});
+    net.setNodesForParams({3});
+    net.setNodesForOutput({4, 4});
+    net.setCs({c});
+    net.setPsi({{0, 0, 0, 0, 1},
+                {0, 0, 0, 0, 0},
+                {0, 0, 0, 0, 0},
+                {0, 0, 0, 0, 1},
+                {0, 0, 0, 0, 1}});
+    return net;
+}
+
+}  // namespace
+
+TEST(Controller, SetNetOperRecompilesOnlyChangedNetworks)
+{
+    NetOper empty;
+    Controller controller({0.0f, 0.0f, 0.0f}, empty);
+    const Model::State state = {-0.1f, 0.0f, 0.0f};
+
+    const NetOper a = makeShiftNet(0.2f);
+    const NetOper b = makeShiftNet(0.5f);   // отличается только параметром
+
+    controller.setNetOper(a);
+    EXPECT_NEAR(controller.calcControl(state).left, 0.3f, 1e-6f);
+    controller.setNetOper(a);
+    EXPECT_NEAR(controller.calcControl(state).left, 0.3f, 1e-6f);
+    controller.setNetOper(b);
+    EXPECT_NEAR(controller.calcControl(state).left, 0.6f, 1e-6f);
+
+    // После записи через netOper() та же сеть компилируется заново
+    controller.netOper().setCs({0.7f});
+    EXPECT_NEAR(controller.calcControl(state).left, 0.8f, 1e-6f);
+    controller.setNetOper(a);
+    EXPECT_NEAR(controller.calcControl(state).left, 0.3f, 1e-6f);
+}
+
+TEST(Controller, WrongArityNetworkIsRejected)
+{
+    NetOper empty;
+    Controller controller({0.0f, 0.0f, 0.0f}, empty);
+    const Model::State state = {-0.1f, 0.0f, 0.0f};
+
+    const NetOper good = makeShiftNet(0.2f);
+    controller.setNetOper(good);
+
+    // 6 выходов переполнили бы массив управления, 4 входа - читали бы за массивом состояния
+    NetOper wide = makeShiftNet(0.5f);
+    wide.setNodesForOutput({4, 4, 4, 4, 4, 4});
+    NetOper extraInput = makeShiftNet(0.5f);
+    extraInput.setNodesForVars({0, 1, 2, 3});
+    EXPECT_THROW(controller.setNetOper(wide), std::invalid_argument);
+    EXPECT_THROW(controller.setNetOper(extraInput), std::invalid_argument);
+    EXPECT_THROW(Controller({0.0f, 0.0f, 0.0f}, wide), std::invalid_argument);
+
+    // отклонённая сеть не заменяет прежнюю
+    EXPECT_NEAR(controller.calcControl(state).left, 0.3f, 1e-6f);
+    EXPECT_EQ(controller.netOper().getNodesForOutput().size(), 2u);
+    EXPECT_NEAR(controller.calcControl(state).left, 0.3f, 1e-6f);
+
+    // интерпретатор тоже не вычисляет сеть неверной размерности
+    controller.netOper().setNodesForOutput({4, 4, 4});
+    EXPECT_THROW(controller.calcControl(state), std::invalid_argument);
+}
@@ -0,0 +1,31 @@
+#include "cpu_dispatch.hpp"
+#include <gtest/gtest.h>
+
+TEST(CpuDispatch, ParseNames) {
+    CpuIsa isa = CpuIsa::Scalar;
+    EXPECT_TRUE(parseCpuIsa("avx2", isa));
+    EXPECT_EQ(isa, CpuIsa::AVX2);
+    EXPECT_TRUE(parseCpuIsa("AVX512", isa));
+    EXPECT_EQ(isa, CpuIsa::AVX512);
+    EXPECT_TRUE(parseCpuIsa("scalar", isa));
+    EXPECT_EQ(isa, CpuIsa::Scalar);
+    EXPECT_FALSE(parseCpuIsa("neon", isa));
+    EXPECT_EQ(isa, CpuIsa::Scalar);
+
+    for (CpuIsa name : {CpuIsa::Scalar, CpuIsa::SSE2, CpuIsa::AVX2, CpuIsa::AVX512}) {
+        ASSERT_TRUE(parseCpuIsa(cpuIsaName(name), isa));
+        EXPECT_EQ(isa, name);
+    }
+}
+
+TEST(CpuDispatch, OverrideIsClampedToCpu) {
+    const CpuIsa initial = activeCpuIsa();
+    const CpuIsa detected = detectCpuIsa();
+    EXPECT_LE(static_cast<int>(initial), static_cast<int>(detected));
+
+    EXPECT_EQ(setActiveCpuIsa(CpuIsa::Scalar), CpuIsa::Scalar);
+    EXPECT_EQ(activeCpuIsa(), CpuIsa::Scalar);
+    EXPECT_EQ(setActiveCpuIsa(CpuIsa::AVX512), detected);
+    EXPECT_EQ(activeCpuIsa(), detected);
+    setActiveCpuIsa(initial);
+}
@@ -0,0 +1,96 @@
+#include "fingerprint_evaluator.hpp"
+#include "base_solution.hpp"
+#include "simple_config.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+/// Считает вызовы; фитнес - номер вызова, чтобы было видно, откуда он взят
+class CountingEvaluator : public IFitnessEvaluator {
+public:
+    std::vector<float> evaluate(const ISolution&) override {
+        return {static_cast<float>(++calls)};
+    }
+    int getNumObjectives() const override { return 1; }
+
+    int calls = 0;
+};
+
+/// y = ro_out(x); дуга 1 -> 2 ведёт в узел, не влияющий на выход
+std::unique_ptr<BaseSolution<SimpleConfig>> makeSolution(const SimpleConfig& config, int out_op, int dead_op) {
+    auto solution = std::make_unique<BaseSolution<SimpleConfig>>(config);
+    NetOper& net = solution->getNetOper();
+    net.setNodesForVars({0});
+    net.setNodesForParams({1});
+    net.setNodesForOutput({3});
+    net.setCs({0.5f});
+    net.setPsi({{0, 0, 0, out_op},
+                {0, 0, dead_op, 0},
+                {0, 0, 1, 0},
+                {0, 0, 0, 1}});
+    return solution;
+}
+
+}  // namespace
+
+TEST(FingerprintEvaluator, DeadArcsShareFitness) {
+    SimpleConfig config;
+    auto inner = std::make_shared<CountingEvaluator>();
+    FingerprintEvaluator evaluator(inner);
+
+    auto a = makeSolution(config, 1, 2);
+    auto b = makeSolution(config, 1, 3);   // отличается только мёртвой дугой
+    auto c = makeSolution(config, 3, 2);   // y = -x
+
+    EXPECT_EQ(evaluator.probe(a->getNetOperConst()), evaluator.probe(b->getNetOperConst()));
+    EXPECT_NE(evaluator.probe(a->getNetOperConst()), evaluator.probe(c->getNetOperConst()));
+
+    const auto fa = evaluator.evaluate(*a);
+    const auto fb = evaluator.evaluate(*b);
+    const auto fc = evaluator.evaluate(*c);
+    EXPECT_EQ(fa, fb);
+    EXPECT_NE(fa, fc);
+    EXPECT_EQ(inner->calls, 2);
+
+    const FingerprintStats stats = evaluator.stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 2);
+    EXPECT_EQ(stats.collisions, 0);
+}
+
+TEST(FingerprintEvaluator, BatchDuplicatesEvaluatedOnce) {
+    SimpleConfig config;
+    auto inner = std::make_shared<CountingEvaluator>();
+    FingerprintEvaluator evaluator(inner);
+
+    auto a = makeSolution(config, 1, 2);
+    auto b = makeSolution(config, 1, 5);
+    auto c = makeSolution(config, 3, 2);
+    const auto results = evaluator.evaluateBatch({a.get(), c.get(), b.get()});
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0], results[2]);
+    EXPECT_NE(results[0], results[1]);
+    EXPECT_EQ(inner->calls, 2);
+
+    // Повтор внутри пакета - попадание, но не промах: misses равно числу симуляций
+    const FingerprintStats stats = evaluator.stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 2);
+}
+
+TEST(FingerprintEvaluator, DisabledPassesThrough) {
+    SimpleConfig config;
+    auto inner = std::make_shared<CountingEvaluator>();
+    FingerprintConfig fingerprint;
+    fingerprint.num_probes = 0;
+    FingerprintEvaluator evaluator(inner, fingerprint);
+
+    auto a = makeSolution(config, 1, 2);
+    evaluator.evaluate(*a);
+    evaluator.evaluate(*a);
+    EXPECT_EQ(inner->calls, 2);
+    EXPECT_EQ(evaluator.stats().hits, 0);
+}
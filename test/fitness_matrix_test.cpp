@@ -0,0 +1,120 @@
+#include "fitness_matrix.hpp"
+#include "cpu_dispatch.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+/// Исходная скалярная проверка доминирования из GANOP::computeRank
+int referenceRank(const std::vector<std::vector<float>>& population, const std::vector<float>& fitness) {
+    const size_t num_obj = fitness.size();
+    int count = 0;
+    for (const auto& other : population) {
+        size_t j = 0;
+        while (j < num_obj && fitness[j] >= other[j]) {
+            j++;
+        }
+        if (j >= num_obj) {
+            size_t k = 0;
+            while (k < num_obj && fitness[k] == other[k]) {
+                k++;
+            }
+            if (k < num_obj) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST(FitnessMatrix, LayoutIsAlignedAndPadded) {
+    FitnessMatrix matrix(37, 3);
+    EXPECT_EQ(matrix.size(), 37u);
+    EXPECT_EQ(matrix.stride() % FitnessMatrix::Lanes, 0u);
+    EXPECT_GE(matrix.stride(), 37u);
+    for (size_t j = 0; j < 3; ++j) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(matrix.column(j)) % FitnessMatrix::Alignment, 0u);
+    }
+    
+    matrix.setRow(5, std::vector<float>{1.0f, 2.0f, 3.0f});
+    EXPECT_EQ(matrix.row(5), (std::vector<float>{1.0f, 2.0f, 3.0f}));
+    EXPECT_FLOAT_EQ(matrix.at(5, 1), 2.0f);
+    EXPECT_EQ(matrix.rows().size(), 37u);
+}
+
+TEST(FitnessMatrix, DominationMatchesScalarReference) {
+    std::mt19937 rng(5);
+    // Малый набор значений - много равенств и частичных равенств
+    std::uniform_int_distribution<int> dist_value(0, 4);
+    
+    for (size_t num_obj : {1u, 2u, 4u, 5u}) {
+        for (size_t size : {1u, 7u, 16u, 33u, 100u}) {
+            std::vector<std::vector<float>> population(size, std::vector<float>(num_obj));
+            FitnessMatrix matrix(size, num_obj);
+            for (size_t i = 0; i < size; ++i) {
+                for (size_t j = 0; j < num_obj; ++j) {
+                    population[i][j] = static_cast<float>(dist_value(rng));
+                }
+                if (i % 11 == 3) {
+                    population[i][0] = std::numeric_limits<float>::quiet_NaN();
+                }
+                matrix.setRow(i, population[i]);
+            }
+            
+            std::vector<int> ranks;
+            matrix.dominationCounts(ranks);
+            ASSERT_EQ(ranks.size(), size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_EQ(ranks[i], referenceRank(population, population[i]));
+            }
+            
+            std::vector<float> candidate(num_obj);
+            for (int trial = 0; trial < 20; ++trial) {
+                for (float& value : candidate) {
+                    value = static_cast<float>(dist_value(rng));
+                }
+                EXPECT_EQ(matrix.countDominating(candidate.data()), referenceRank(population, candidate));
+            }
+        }
+    }
+}
+
+TEST(FitnessMatrix, AllKernelsAgree) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> dist_value(0, 3);
+    const CpuIsa initial = activeCpuIsa();
+    const CpuIsa detected = detectCpuIsa();
+
+    for (size_t num_obj : {1u, 3u, 6u}) {
+        for (size_t size : {5u, 16u, 50u}) {
+            FitnessMatrix matrix(size, num_obj);
+            for (size_t i = 0; i < size; ++i) {
+                for (size_t j = 0; j < num_obj; ++j) {
+                    matrix.set(i, j, i % 7 == 2 ? std::numeric_limits<float>::quiet_NaN()
+                                                : static_cast<float>(dist_value(rng)));
+                }
+            }
+
+            setActiveCpuIsa(CpuIsa::Scalar);
+            std::vector<int> expected;
+            matrix.dominationCounts(expected);
+
+            for (CpuIsa isa : {CpuIsa::SSE2, CpuIsa::AVX2, CpuIsa::AVX512}) {
+                if (static_cast<int>(isa) > static_cast<int>(detected)) {
+                    continue;
+                }
+                ASSERT_EQ(setActiveCpuIsa(isa), isa);
+                std::vector<int> ranks;
+                matrix.dominationCounts(ranks);
+                EXPECT_EQ(ranks, expected) << cpuIsaName(isa);
+            }
+        }
+    }
+    setActiveCpuIsa(initial);
+}
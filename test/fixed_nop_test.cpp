@@ -0,0 +1,92 @@
+#include "fixed_nop.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace {
+
+using ReferenceNetOper = FixedNetOper<24, 3, 3, 2>;
+
+NetOper makeReferenceNet() {
+    NetOper net;
+    net.setNodesForVars({0, 1, 2});
+    net.setNodesForParams({3, 4, 5});
+    net.setNodesForOutput({22, 23});
+    net.setCs(qc);
+    net.setPsi(NopPsiN);
+    return net;
+}
+
+}  // namespace
+
+TEST(FixedNetOper, MatchesNetOperBitForBit) {
+    NetOper net = makeReferenceNet();
+    const ReferenceNetOper fixed(net);
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-20.0f, 20.0f);
+    for (int sample = 0; sample < 500; ++sample) {
+        const std::array<float, 3> x = {dist(rng), dist(rng), dist(rng)};
+        float expected[2];
+        net.calcResult(x.data(), expected);
+        const std::array<float, 2> actual = fixed.calcResult(x);
+        EXPECT_EQ(actual[0], expected[0]);
+        EXPECT_EQ(actual[1], expected[1]);
+    }
+}
+
+TEST(FixedNetOper, RoundTripThroughNetOper) {
+    NetOper net = makeReferenceNet();
+    const ReferenceNetOper fixed(net);
+    NetOper back = fixed.toNetOper();
+
+    // Элементы ниже диагонали и лишние параметры NetOper не использует, они не переносятся
+    const auto& psi = net.getPsi();
+    const auto& restored = back.getPsi();
+    ASSERT_EQ(restored.size(), psi.size());
+    for (size_t i = 0; i < psi.size(); ++i) {
+        for (size_t j = i; j < psi.size(); ++j) {
+            EXPECT_EQ(restored[i][j], psi[i][j]) << i << ", " << j;
+        }
+    }
+    EXPECT_EQ(back.getCs(), std::vector<float>(qc.begin(), qc.begin() + 3));
+    EXPECT_EQ(back.getNodesForVars(), net.getNodesForVars());
+    EXPECT_EQ(back.getNodesForParams(), net.getNodesForParams());
+    EXPECT_EQ(back.getNodesForOutput(), net.getNodesForOutput());
+}
+
+TEST(FixedNetOper, RobotDimensions) {
+    NetOper net = makeReferenceNet();
+    net.setNodesForParams({3, 4, 5, 6, 7, 8, 9, 10});
+    net.setCs({50150.5f, 23227.4f, 5022.71f, 37037.5f, 376.38f, 2979.02f, 14908.7f, 27469.4f});
+    const RobotNetOper fixed(net);
+
+    const float x[3] = {1.0f, -0.5f, 0.25f};
+    float expected[2];
+    float actual[2];
+    net.calcResult(x, expected);
+    fixed.calcResult(x, actual);
+    EXPECT_EQ(actual[0], expected[0]);
+    EXPECT_EQ(actual[1], expected[1]);
+}
+
+TEST(FixedNetOper, DoubleScalar) {
+    NetOper net = makeReferenceNet();
+    const FixedNetOper<24, 3, 3, 2, double> fixed(net);
+
+    const std::array<double, 3> x = {0.5, 1.5, -2.0};
+    const float xf[3] = {0.5f, 1.5f, -2.0f};
+    float expected[2];
+    net.calcResult(xf, expected);
+    const auto actual = fixed.calcResult(x);
+    EXPECT_FLOAT_EQ(static_cast<float>(actual[0]), expected[0]);
+    EXPECT_FLOAT_EQ(static_cast<float>(actual[1]), expected[1]);
+}
+
+TEST(FixedNetOper, WrongDimensionsThrow) {
+    NetOper net = makeReferenceNet();
+    EXPECT_THROW((FixedNetOper<23, 3, 3, 2>(net)), std::invalid_argument);
+    EXPECT_THROW((FixedNetOper<24, 2, 3, 2>(net)), std::invalid_argument);
+    EXPECT_THROW((FixedNetOper<24, 3, 3, 1>(net)), std::invalid_argument);
+    EXPECT_THROW((FixedNetOper<24, 3, 4, 2>(net)), std::invalid_argument);
+}
@@ -0,0 +1,118 @@
+#include "fixed_point.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Q16 = Fixed<16>;
+
+/// Ошибка с учётом масштаба: абсолютная около нуля, относительная для больших значений
+float scaledError(float actual, float expected) {
+    return std::fabs(actual - expected) / std::max(1.0f, std::fabs(expected));
+}
+
+}  // namespace
+
+TEST(FixedPoint, ConversionAndSaturation) {
+    EXPECT_EQ(Q16::fromFloat(1.5f).raw, 3 << 15);
+    EXPECT_FLOAT_EQ(Q16::fromFloat(-2.25f).toFloat(), -2.25f);
+    EXPECT_EQ(Q16::fromFloat(1e9f).raw, std::numeric_limits<int32_t>::max());
+    EXPECT_EQ(Q16::fromFloat(-1e9f).raw, -std::numeric_limits<int32_t>::max());
+    EXPECT_EQ(Q16::fromFloat(NAN).raw, 0);
+
+    const Q16 big = Q16::fromFloat(30000.0f);
+    EXPECT_FLOAT_EQ(FixedMath<16>::binary(1, big, big).toFloat(), Q16::maxValue());
+    EXPECT_FLOAT_EQ(FixedMath<16>::binary(2, big, Q16::fromFloat(-2.0f)).toFloat(), -Q16::maxValue());
+    EXPECT_FLOAT_EQ(FixedMath<16>::unary(3, Q16::fromRaw(-Q16::Max)).toFloat(), Q16::maxValue());
+}
+
+TEST(FixedPoint, UnaryOperationsTrackFloat) {
+    for (int op = 1; op <= NumUnaryFunctions; ++op) {
+        float worst = 0.0f;
+        for (float x = -5.013f; x < 5.0f; x += 0.0731f) {
+            const float expected = UnaryFunctions[op](x);
+            if (std::fabs(expected) >= Q16::maxValue()) {
+                continue;
+            }
+            // Вход квантуется, поэтому эталон - float от квантованного входа
+            const Q16 fx = Q16::fromFloat(x);
+            const float reference = UnaryFunctions[op](fx.toFloat());
+            worst = std::max(worst, scaledError(FixedMath<16>::unary(op, fx).toFloat(), reference));
+        }
+        EXPECT_LT(worst, 2e-3f) << "ro_" << op;
+    }
+}
+
+TEST(FixedPoint, BinaryOperationsTrackFloat) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(-50.0f, 50.0f);
+    for (int op = 1; op <= NumBinaryFunctions; ++op) {
+        float worst = 0.0f;
+        for (int sample = 0; sample < 2000; ++sample) {
+            const Q16 l = Q16::fromFloat(dist(rng));
+            const Q16 r = Q16::fromFloat(dist(rng));
+            const float expected = BinaryFunctions[op](l.toFloat(), r.toFloat());
+            worst = std::max(worst, scaledError(FixedMath<16>::binary(op, l, r).toFloat(), expected));
+        }
+        EXPECT_LT(worst, 1e-4f) << "xi_" << op;
+    }
+}
+
+TEST(FixedPoint, ReferenceNetworkAccuracy) {
+    NetOper net;
+    net.setNodesForVars({0, 1, 2});
+    net.setNodesForParams({3, 4, 5});
+    net.setNodesForOutput({22, 23});
+    net.setCs(qc);
+    net.setPsi(NopPsiN);
+
+    // Параметры порядка 5e4: нужен формат с запасом целых бит
+    const FixedNetOper<24, 3, 3, 2, Fixed<12>> fixed(net);
+
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+    std::vector<std::array<float, 3>> inputs(500);
+    for (auto& x : inputs) {
+        x = {dist(rng), dist(rng), dist(rng)};
+    }
+
+    // Сеть берёт sin от величин ~2e4, где шаг Q19.12 сравним с периодом, поэтому
+    // проверяется только полнота отчёта; точность - на гладкой сети ниже
+    const FixedPointAccuracy report = fixedPointAccuracy(net, fixed, inputs);
+    EXPECT_EQ(report.samples + report.saturated, inputs.size() * 2);
+    EXPECT_GT(report.samples, 0u);
+    EXPECT_LE(report.mean_abs_error, report.max_abs_error);
+}
+
+TEST(FixedPoint, SmoothNetworkAccuracy) {
+    // y0 = atan(x0 + x1) * c, y1 = exp(-|x2|) * sign(x2) + sin(x0)
+    NetOper net;
+    net.setNodesForVars({0, 1, 2});
+    net.setNodesForParams({3});
+    net.setNodesForOutput({5, 6});
+    net.setCs({1.5f});
+    net.setPsi({
+        {0, 0, 0, 0, 1, 0, 12},
+        {0, 0, 0, 0, 1, 0, 0},
+        {0, 0, 0, 0, 0, 0, 19},
+        {0, 0, 0, 0, 0, 1, 0},
+        {0, 0, 0, 0, 1, 13, 0},
+        {0, 0, 0, 0, 0, 2, 0},
+        {0, 0, 0, 0, 0, 0, 1},
+    });
+    const FixedNetOper<7, 3, 1, 2, Fixed<16>> fixed(net);
+
+    std::vector<std::array<float, 3>> inputs;
+    for (float a = -3.0f; a <= 3.0f; a += 0.25f) {
+        for (float b = -3.0f; b <= 3.0f; b += 0.5f) {
+            inputs.push_back({a, b, a - b});
+        }
+    }
+    const FixedPointAccuracy report = fixedPointAccuracy(net, fixed, inputs);
+    EXPECT_EQ(report.samples, inputs.size() * 2);
+    EXPECT_EQ(report.saturated, 0u);
+    EXPECT_LT(report.max_abs_error, 1e-3f);
+}
@@ -0,0 +1,457 @@
+#include "GANOP.hpp"
+#include "island_model.hpp"
+#include "net_archive.hpp"
+#include "rank_heap.hpp"
+#include "base_solution.hpp"
+#include "simple_config.hpp"
+#include "simple_fitness_evaluator.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+
+namespace {
+
+GAConfig makeTestGAConfig(const SimpleConfig& simple_config, int generations) {
+    GAConfig ga_config;
+    ga_config.nodes_for_vars = simple_config.nodes_for_vars;
+    ga_config.nodes_for_params = simple_config.nodes_for_params;
+    ga_config.nodes_for_output = simple_config.nodes_for_output;
+    
+    ga_config.population_size = 40;
+    ga_config.num_generations = generations;
+    ga_config.num_crossovers_per_gen = 8;
+    ga_config.mutation_prob = 0.5f;
+    ga_config.search_neighbors = 4;
+    ga_config.num_params = 2;
+    ga_config.int_bits = 4;
+    ga_config.frac_bits = 8;
+    ga_config.num_struct_variations = 6;
+    ga_config.seed = 7;
+    
+    ga_config.nop_template = std::make_shared<NetOper>();
+    ga_config.nop_template->setNodesForVars(simple_config.nodes_for_vars);
+    ga_config.nop_template->setNodesForParams(simple_config.nodes_for_params);
+    ga_config.nop_template->setNodesForOutput(simple_config.nodes_for_output);
+    ga_config.nop_template->setCs(simple_config.base_params);
+    ga_config.nop_template->setPsi(simple_config.base_matrix);
+    
+    ga_config.fitness_evaluator = std::make_shared<SimpleFitnessEvaluator>(simple_config, 1);
+    ga_config.solution_factory = [simple_config]() -> std::unique_ptr<ISolution> {
+        auto solution = std::make_unique<BaseSolution<SimpleConfig>>(simple_config);
+        solution->setIntBits(4);
+        solution->setFracBits(8);
+        return solution;
+    };
+    return ga_config;
+}
+
+/// Считает вызовы evaluate() и сообщает ненулевой хэш, чтобы фитнес из архива переиспользовался
+class CountingEvaluator : public SimpleFitnessEvaluator {
+public:
+    using SimpleFitnessEvaluator::SimpleFitnessEvaluator;
+    
+    std::vector<float> evaluate(const ISolution& solution) override {
+        ++calls;
+        return SimpleFitnessEvaluator::evaluate(solution);
+    }
+    
+    uint64_t getConfigHash() const override { return 0xC0FFEEu; }
+    
+    int calls = 0;
+};
+
+/// Потокобезопасный счётчик вызовов для асинхронного режима
+class AtomicCountingEvaluator : public SimpleFitnessEvaluator {
+public:
+    using SimpleFitnessEvaluator::SimpleFitnessEvaluator;
+    
+    std::vector<float> evaluate(const ISolution& solution) override {
+        ++calls;
+        return SimpleFitnessEvaluator::evaluate(solution);
+    }
+    
+    std::atomic<int> calls{0};
+};
+
+/// Два критерия: ошибка и число дуг сети - фронт из нескольких решений, которые вытесняют друг друга
+class TwoObjectiveEvaluator : public SimpleFitnessEvaluator {
+public:
+    explicit TwoObjectiveEvaluator(const SimpleConfig& config)
+        : SimpleFitnessEvaluator(config, 2) {}
+    
+    std::vector<float> evaluate(const ISolution& solution) override {
+        const auto& psi = solution.getNetOperConst().getPsi();
+        float arcs = 0.0f;
+        for (size_t i = 0; i < psi.size(); ++i) {
+            for (size_t j = i + 1; j < psi[i].size(); ++j) {
+                arcs += psi[i][j] != 0 ? 1.0f : 0.0f;
+            }
+        }
+        return {SimpleFitnessEvaluator::evaluate(solution).front(), arcs};
+    }
+};
+
+SimpleConfig makeTestSimpleConfig() {
+    SimpleConfig simple_config;
+    simple_config.num_samples = 50;
+    return simple_config;
+}
+
+}  // namespace
+
+TEST(GANOP, ResumeFromCheckpointIsBitIdentical) {
+    const std::string fullCheckpoint = "/tmp/test_ganop_full.ckpt";
+    const std::string splitCheckpoint = "/tmp/test_ganop_split.ckpt";
+    std::remove(fullCheckpoint.c_str());
+    std::remove(splitCheckpoint.c_str());
+    const SimpleConfig simple_config = makeTestSimpleConfig();
+    
+    // Два критерия, чтобы архив элиты содержал несколько решений и терял вытесненные
+    auto evaluator = std::make_shared<TwoObjectiveEvaluator>(simple_config);
+    auto makeConfig = [&](int generations) {
+        GAConfig config = makeTestGAConfig(simple_config, generations);
+        config.fitness_evaluator = evaluator;
+        return config;
+    };
+    
+    // Непрерывный запуск на 6 поколений
+    GAConfig full_config = makeConfig(6);
+    full_config.checkpoint_path = fullCheckpoint;
+    GANOP full(full_config);
+    full.run();
+    
+    // Запуск на 3 поколения, затем продолжение с чекпоинта до 6
+    GAConfig first_config = makeConfig(3);
+    first_config.checkpoint_path = splitCheckpoint;
+    GANOP first(first_config);
+    first.run();
+    
+    int generation = -1;
+    GANOP probe(makeConfig(6));
+    ASSERT_TRUE(probe.loadCheckpoint(splitCheckpoint, generation));
+    EXPECT_EQ(generation, 3);
+    
+    GAConfig resumed_config = makeConfig(6);
+    resumed_config.checkpoint_path = splitCheckpoint;
+    int first_generation_seen = -1;
+    resumed_config.on_generation_end = [&first_generation_seen](int gen, float) {
+        if (first_generation_seen < 0) first_generation_seen = gen;
+    };
+    GANOP resumed(resumed_config);
+    resumed.run();
+    
+    EXPECT_EQ(first_generation_seen, 4);
+    EXPECT_EQ(resumed.getAllFitness(), full.getAllFitness());
+    EXPECT_EQ(resumed.getParetoIndices(), full.getParetoIndices());
+    
+    // Архив элиты - те же решения в том же порядке (он же пишется в чекпоинт и elite_archive_path)
+    const auto full_elites = full.getEliteArchive().entries();
+    const auto resumed_elites = resumed.getEliteArchive().entries();
+    ASSERT_EQ(resumed_elites.size(), full_elites.size());
+    EXPECT_GT(full_elites.size(), 0u);
+    for (size_t i = 0; i < full_elites.size(); ++i) {
+        EXPECT_EQ(resumed_elites[i]->fitness, full_elites[i]->fitness) << "elite " << i;
+        EXPECT_EQ(resumed_elites[i]->params, full_elites[i]->params) << "elite " << i;
+        EXPECT_EQ(resumed_elites[i]->structure, full_elites[i]->structure) << "elite " << i;
+    }
+    
+    // Последние чекпоинты обоих запусков совпадают байт в байт
+    auto readFile = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    EXPECT_EQ(readFile(splitCheckpoint), readFile(fullCheckpoint));
+    
+    std::remove(fullCheckpoint.c_str());
+    std::remove(splitCheckpoint.c_str());
+}
+
+TEST(GANOP, RunDependsOnlyOnSeed) {
+    const SimpleConfig simple_config = makeTestSimpleConfig();
+    
+    // Глобальный rand() в разном состоянии не должен влиять на результат
+    std::srand(1);
+    GANOP first(makeTestGAConfig(simple_config, 3));
+    first.run();
+    
+    std::srand(12345);
+    for (int i = 0; i < 17; ++i) {
+        std::rand();
+    }
+    GANOP second(makeTestGAConfig(simple_config, 3));
+    second.run();
+    
+    EXPECT_EQ(first.getAllFitness(), second.getAllFitness());
+    EXPECT_EQ(first.getParetoIndices(), second.getParetoIndices());
+    
+    GAConfig other_config = makeTestGAConfig(simple_config, 3);
+    other_config.seed = 8;
+    GANOP other(other_config);
+    other.run();
+    EXPECT_NE(first.getAllFitness(), other.getAllFitness());
+}
+
+TEST(GANOP, EffectiveMutationsAlwaysChangeMatrix) {
+    const SimpleConfig simple_config = makeTestSimpleConfig();
+    
+    GANOP plain(makeTestGAConfig(simple_config, 4));
+    plain.run();
+    EXPECT_GT(plain.getMutationStats().mutations, 0);
+    EXPECT_GT(plain.getMutationStats().noop_variations, 0);
+    EXPECT_EQ(plain.getMutationStats().resampled_variations, 0);
+    
+    GAConfig config = makeTestGAConfig(simple_config, 4);
+    config.effective_mutations = true;
+    GANOP effective(config);
+    effective.run();
+    EXPECT_GT(effective.getMutationStats().mutations, 0);
+    EXPECT_EQ(effective.getMutationStats().noop_variations, 0);
+    EXPECT_GT(effective.getMutationStats().resampled_variations, 0);
+}
+
+TEST(GANOP, EffectiveMutationsDecodeFromSolutionBase) {
+    // Шаблон сети отличается от base_matrix, из которой декодируются решения
+    // (как в train после загрузки best_net.bin). Случайные вариации от матрицы
+    // шаблона не зависят, поэтому запуск должен совпасть с запуском без подмены
+    const SimpleConfig simple_config = makeTestSimpleConfig();
+    GAConfig config = makeTestGAConfig(simple_config, 4);
+    config.effective_mutations = true;
+    GANOP reference(config);
+    reference.run();
+    
+    GAConfig swapped = makeTestGAConfig(simple_config, 4);
+    swapped.effective_mutations = true;
+    auto psi = simple_config.base_matrix;
+    for (size_t i = 0; i < psi.size(); ++i) {
+        for (size_t j = i + 1; j < psi.size(); ++j) {
+            psi[i][j] = 0;
+        }
+    }
+    swapped.nop_template->setPsi(psi);
+    GANOP run(swapped);
+    run.run();
+    
+    EXPECT_EQ(run.getMutationStats().mutations, reference.getMutationStats().mutations);
+    EXPECT_EQ(run.getMutationStats().resampled_variations, reference.getMutationStats().resampled_variations);
+    EXPECT_EQ(run.getMutationStats().noop_variations, 0);
+    EXPECT_EQ(run.getAllFitness(), reference.getAllFitness());
+}
+
+TEST(GANOP, CheckpointFromOtherConfigIsIgnored) {
+    const std::string checkpoint = "/tmp/test_ganop_other.ckpt";
+    const SimpleConfig simple_config = makeTestSimpleConfig();
+    
+    GAConfig config = makeTestGAConfig(simple_config, 1);
+    config.checkpoint_path = checkpoint;
+    GANOP ga(config);
+    ga.run();
+    
+    int generation = -1;
+    GANOP same(makeTestGAConfig(simple_config, 1));
+    EXPECT_TRUE(same.loadCheckpoint(checkpoint, generation));
+    EXPECT_EQ(generation, 1);
+    
+    GAConfig other_config = makeTestGAConfig(simple_config, 1);
+    other_config.selection_alpha = 0.25f;
+    GANOP other(other_config);
+    EXPECT_FALSE(other.loadCheckpoint(checkpoint, generation));
+    
+    // Повреждённый файл отклоняется по контрольной сумме
+    {
+        std::fstream file(checkpoint, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(100);
+        file.put('\x7f');
+    }
+    EXPECT_FALSE(same.loadCheckpoint(checkpoint, generation));
+    
+    std::remove(checkpoint.c_str());
+}
+
+TEST(GANOP, WarmStartFromParetoArchive) {
+    const std::string archivePath = "/tmp/test_ganop_front.nar";
+    const SimpleConfig simple_config = makeTestSimpleConfig();
+    
+    GAConfig first_config = makeTestGAConfig(simple_config, 3);
+    first_config.fitness_evaluator = std::make_shared<CountingEvaluator>(simple_config, 1);
+    first_config.pareto_archive_path = archivePath;
+    GANOP first(first_config);
+    first.run();
+    const size_t front_size = first.getParetoIndices().size();
+    const float best = first.getAllFitness()[first.getBestParetoIndex()][0];
+    
+    // Новый запуск без поколений: только инициализация и оценка
+    auto evaluator = std::make_shared<CountingEvaluator>(simple_config, 1);
+    GAConfig warm_config = makeTestGAConfig(simple_config, 0);
+    warm_config.fitness_evaluator = evaluator;
+    warm_config.warm_start_archive = archivePath;
+    warm_config.seed = 11;
+    GANOP warm(warm_config);
+    warm.run();
+    
+    // Сети фронта восстановлены точно - их фитнес не пересчитывается
+    EXPECT_EQ(evaluator->calls, warm_config.population_size - static_cast<int>(front_size));
+    EXPECT_LE(warm.getAllFitness()[warm.getBestParetoIndex()][0], best);
+    
+    // Другой хэш evaluator'а - сети из архива оцениваются заново, фитнес тот же
+    // (проверяются особи архива 1..front_size; остальные случайные, их даёт CounterRng по seed)
+    auto other = std::make_shared<SimpleFitnessEvaluator>(simple_config, 1);
+    GAConfig cold_config = warm_config;
+    cold_config.fitness_evaluator = other;
+    GANOP cold(cold_config);
+    cold.run();
+    for (size_t i = 1; i <= front_size; ++i) {
+        EXPECT_EQ(cold.getAllFitness()[i], warm.getAllFitness()[i]);
+    }
+    
+    std::remove(archivePath.c_str());
+}
+
+TEST(GANOP, EliteArchiveKeepsWholeRunFront) {
+    const std::string archive_path = "/tmp/test_ganop_elite.nar";
+    const SimpleConfig simple_config = makeTestSimpleConfig();
+    
+    GAConfig config = makeTestGAConfig(simple_config, 4);
+    config.elite_archive_path = archive_path;
+    GANOP ga(config);
+    ga.run();
+    
+    const ParetoArchive& elite = ga.getEliteArchive();
+    ASSERT_FALSE(elite.empty());
+    
+    // Парето-фронт популяции не лучше архива
+    const auto fitness = ga.getAllFitness();
+    for (int idx : ga.getParetoIndices()) {
+        EXPECT_TRUE(elite.isDominated(fitness[idx]));
+    }
+    
+    NetArchive archive;
+    ASSERT_TRUE(archive.open(archive_path));
+    ASSERT_EQ(archive.size(), elite.size());
+    const auto entries = elite.entries();
+    for (size_t k = 0; k < archive.size(); ++k) {
+        EXPECT_EQ(archive.fitness(k)[0], entries[k]->fitness[0]);
+    }
+    archive.close();
+    std::remove(archive_path.c_str());
+}
+
+TEST(GANOP, ImmigrantReplacesWorst) {
+    const SimpleConfig simple_config = makeTestSimpleConfig();
+    
+    GAConfig source_config = makeTestGAConfig(simple_config, 0);
+    GANOP source(source_config);
+    source.initialize();
+    
+    GAConfig target_config = makeTestGAConfig(simple_config, 0);
+    target_config.seed = 100;
+    GANOP target(target_config);
+    target.initialize();
+    
+    auto migrants = source.emigrants(2);
+    ASSERT_FALSE(migrants.empty());
+    ASSERT_LE(migrants.size(), 2u);
+    EXPECT_EQ(migrants.front().fitness, source.getAllFitness()[source.getBestParetoIndex()]);
+    
+    EXPECT_GE(target.immigrate(migrants), 1);
+    const auto& fitness = target.getAllFitness();
+    EXPECT_NE(std::find(fitness.begin(), fitness.end(), migrants.front().fitness), fitness.end());
+}
+
+TEST(GANOP, AsynchronousSteadyState) {
+    const SimpleConfig simple_config = makeTestSimpleConfig();
+    auto evaluator = std::make_shared<AtomicCountingEvaluator>(simple_config, 1);
+    
+    GAConfig config = makeTestGAConfig(simple_config, 4);
+    config.fitness_evaluator = evaluator;
+    config.asynchronous = true;
+    config.async_workers = 3;
+    std::vector<int> reported;
+    std::vector<float> averages;
+    config.on_generation_end = [&reported, &averages](int gen, float avg) {
+        reported.push_back(gen);
+        averages.push_back(avg);
+    };
+    
+    GANOP ga(config);
+    ga.run();
+    
+    // Каждое поколение - ровно num_crossovers_per_gen * 4 оценённых потомков
+    EXPECT_EQ(evaluator->calls.load(),
+              config.population_size + config.num_generations * config.num_crossovers_per_gen * 4);
+    EXPECT_EQ(reported, (std::vector<int>{0, 1, 2, 3, 4}));
+    ASSERT_EQ(ga.getAllFitness().size(), static_cast<size_t>(config.population_size));
+    EXPECT_FALSE(ga.getParetoIndices().empty());
+    
+    // Худшие заменяются только лучшими по рангу - средний фитнес не взрывается
+    EXPECT_LE(averages.back(), averages.front());
+}
+
+TEST(RankHeap, MatchesLinearScanForWorst) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> dist_rank(0, 9);
+    std::vector<int> ranks(257);
+    for (int& rank : ranks) {
+        rank = dist_rank(rng);
+    }
+    
+    RankHeap heap;
+    heap.assign(ranks);
+    std::uniform_int_distribution<int> dist_idx(0, static_cast<int>(ranks.size()) - 1);
+    for (int step = 0; step < 5000; ++step) {
+        // Как в GANOP: первый индекс с наибольшим рангом
+        const int expected = static_cast<int>(std::max_element(ranks.begin(), ranks.end()) - ranks.begin());
+        ASSERT_EQ(heap.top(), expected);
+        ASSERT_EQ(heap.topRank(), ranks[expected]);
+        
+        const int idx = step % 3 == 0 ? expected : dist_idx(rng);
+        ranks[idx] = dist_rank(rng);
+        heap.update(idx, ranks[idx]);
+    }
+}
+
+TEST(IslandModel, RunsIslandsWithMigration) {
+    const std::string archivePath = "/tmp/test_islands_front.nar";
+    const SimpleConfig simple_config = makeTestSimpleConfig();
+    
+    GAConfig config = makeTestGAConfig(simple_config, 5);
+    config.pareto_archive_path = archivePath;
+    std::vector<int> reported;
+    config.on_generation_end = [&reported](int gen, float) { reported.push_back(gen); };
+    int finished = 0;
+    config.on_algorithm_end = [&finished](const ISolution&) { ++finished; };
+    
+    IslandConfig island_config;
+    island_config.num_islands = 3;
+    island_config.migration_interval = 2;
+    island_config.migrants_per_island = 2;
+    island_config.topology = MigrationTopology::FullyConnected;
+    
+    IslandModel model(config, island_config);
+    model.run();
+    
+    // Отчёт после инициализации и после каждой эпохи между миграциями
+    EXPECT_EQ(reported, (std::vector<int>{0, 2, 4, 5}));
+    EXPECT_EQ(finished, 1);
+    ASSERT_EQ(model.numIslands(), 3);
+    
+    size_t front_size = 0;
+    const int best_island = model.getBestIsland();
+    const float best = model.island(best_island).getAllFitness()[model.island(best_island).getBestParetoIndex()][0];
+    for (int i = 0; i < model.numIslands(); ++i) {
+        const GANOP& island = model.island(i);
+        EXPECT_EQ(island.getAllFitness().size(), static_cast<size_t>(config.population_size));
+        EXPECT_GE(island.getAllFitness()[island.getBestParetoIndex()][0], best);
+        front_size += island.getParetoIndices().size();
+    }
+    
+    NetArchive archive;
+    ASSERT_TRUE(archive.open(archivePath));
+    EXPECT_EQ(archive.size(), front_size);
+    archive.close();
+    std::remove(archivePath.c_str());
+}
@@ -0,0 +1,166 @@
+#include "net_archive.hpp"
+#include "nop_test_utils.h"
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace {
+
+NetOper makeArchiveNetOper(float paramShift) {
+    auto netOper = NetOper();
+    netOper.setNodesForVars({0, 1, 2});
+    netOper.setNodesForParams({3, 4, 5});
+    netOper.setNodesForOutput({22, 23});
+    std::vector<float> params = qc;
+    for (auto& p : params) {
+        p += paramShift;
+    }
+    netOper.setCs(params);
+    netOper.setPsi(NopPsiN);
+    return netOper;
+}
+
+}  // namespace
+
+TEST(NetArchive, write_and_iterate) {
+    std::string testFile = "/tmp/test_networks.nar";
+    const int count = 50;
+    
+    NetArchiveWriter writer;
+    ASSERT_TRUE(writer.open(testFile, 2, 0x1234u));
+    for (int i = 0; i < count; ++i) {
+        ASSERT_TRUE(writer.add(makeArchiveNetOper(0.1f * i), {1.0f * i, -1.0f * i}));
+    }
+    EXPECT_EQ(writer.size(), static_cast<size_t>(count));
+    ASSERT_TRUE(writer.close());
+    
+    NetArchive archive;
+    ASSERT_TRUE(archive.open(testFile));
+    ASSERT_EQ(archive.size(), static_cast<size_t>(count));
+    EXPECT_EQ(archive.numObjectives(), 2u);
+    EXPECT_EQ(archive.configHash(), 0x1234u);
+    
+    std::vector<float> x_in = {1.0f, -0.5f, 0.2f};
+    std::vector<float> expected(2), actual(2);
+    NetOper net;
+    for (int i = 0; i < count; ++i) {
+        // образ лежит внутри отображения, выровнен на 8 байт
+        size_t imageSize = 0;
+        const char* image = archive.image(i, imageSize);
+        ASSERT_NE(image, nullptr);
+        EXPECT_GT(imageSize, 0u);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(image) % 8, 0u);
+        
+        ASSERT_TRUE(archive.get(i, net));
+        auto reference = makeArchiveNetOper(0.1f * i);
+        EXPECT_EQ(net.getPsi(), NopPsiN);
+        ASSERT_EQ(net.getCs().size(), reference.getCs().size());
+        EXPECT_FLOAT_EQ(net.getCs()[0], reference.getCs()[0]);
+        
+        reference.calcResult(x_in, expected);
+        net.calcResult(x_in, actual);
+        EXPECT_FLOAT_EQ(actual[0], expected[0]);
+        EXPECT_FLOAT_EQ(actual[1], expected[1]);
+        
+        const float* fitness = archive.fitness(i);
+        ASSERT_NE(fitness, nullptr);
+        EXPECT_FLOAT_EQ(fitness[0], 1.0f * i);
+        EXPECT_FLOAT_EQ(fitness[1], -1.0f * i);
+    }
+    
+    size_t imageSize = 0;
+    EXPECT_EQ(archive.image(count, imageSize), nullptr);
+    EXPECT_FALSE(archive.get(count, net));
+    
+    archive.close();
+    EXPECT_FALSE(archive.isOpen());
+    std::remove(testFile.c_str());
+}
+
+TEST(NetArchive, without_fitness) {
+    std::string testFile = "/tmp/test_networks_nofit.nar";
+    {
+        NetArchiveWriter writer;
+        ASSERT_TRUE(writer.open(testFile));
+        EXPECT_TRUE(writer.add(makeArchiveNetOper(0.0f)));
+        // фитнес не ожидается - вектор неверного размера отклоняется
+        EXPECT_FALSE(writer.add(makeArchiveNetOper(0.0f), {1.0f}));
+        // close() вызывается деструктором
+    }
+    
+    NetArchive archive;
+    ASSERT_TRUE(archive.open(testFile));
+    EXPECT_EQ(archive.size(), 1u);
+    EXPECT_EQ(archive.numObjectives(), 0u);
+    EXPECT_EQ(archive.fitness(0), nullptr);
+    
+    std::remove(testFile.c_str());
+}
+
+TEST(NetArchive, rejects_foreign_file) {
+    std::string testFile = "/tmp/test_not_archive.nar";
+    {
+        std::ofstream file(testFile, std::ios::binary);
+        file << std::string(128, 'x');
+    }
+    
+    NetArchive archive;
+    EXPECT_FALSE(archive.open(testFile));
+    EXPECT_FALSE(archive.isOpen());
+    EXPECT_FALSE(archive.open("/tmp/nonexistent_archive_12345.nar"));
+    
+    std::remove(testFile.c_str());
+}
+
+TEST(NetArchive, rejects_corrupted_header) {
+    std::string testFile = "/tmp/test_corrupted_archive.nar";
+    // переписать uint64 по смещению в готовом архиве
+    auto patch = [&](size_t offset, uint64_t value) {
+        std::fstream file(testFile, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto rewrite = [&](uint32_t num_objectives) {
+        NetArchiveWriter writer;
+        ASSERT_TRUE(writer.open(testFile, num_objectives));
+        ASSERT_TRUE(writer.add(makeArchiveNetOper(0.0f), std::vector<float>(num_objectives, 1.0f)));
+        ASSERT_TRUE(writer.close());
+    };
+    const size_t numNetworksOffset = offsetof(NetArchiveHeader, num_networks);
+    const size_t indexOffsetOffset = offsetof(NetArchiveHeader, index_offset);
+
+    NetArchive archive;
+    // произведения размеров переполняют uint64 и проходили бы проверку "> размера файла"
+    rewrite(0);
+    patch(numNetworksOffset, 1ull << 60);
+    EXPECT_FALSE(archive.open(testFile));
+    rewrite(2);
+    patch(numNetworksOffset, 1ull << 61);
+    EXPECT_FALSE(archive.open(testFile));
+    rewrite(0);
+    patch(indexOffsetOffset, ~0ull - 7);
+    EXPECT_FALSE(archive.open(testFile));
+
+    // запись индекса, у которой offset + size переполняется
+    rewrite(0);
+    ASSERT_TRUE(archive.open(testFile));
+    uint64_t indexOffset = 0;
+    {
+        std::ifstream file(testFile, std::ios::binary);
+        file.seekg(indexOffsetOffset);
+        file.read(reinterpret_cast<char*>(&indexOffset), sizeof(indexOffset));
+    }
+    archive.close();
+    patch(indexOffset + offsetof(NetArchiveEntry, offset), 64);
+    patch(indexOffset + offsetof(NetArchiveEntry, size), ~0ull - 32);
+    ASSERT_TRUE(archive.open(testFile));
+    size_t imageSize = 0;
+    EXPECT_EQ(archive.image(0, imageSize), nullptr);
+    NetOper net;
+    EXPECT_FALSE(archive.get(0, net));
+    archive.close();
+
+    std::remove(testFile.c_str());
+}
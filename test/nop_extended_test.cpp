@@ -3,6 +3,8 @@
 #include <gtest/gtest.h>
 #include <fstream>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 // Test file I/O operations for matrices
 TEST(NOP_FileIO, save_and_load_matrix) {
@@ -157,6 +159,87 @@ TEST(NOP_Genetic, genvar_returns_valid_vector) {
     EXPECT_LE(w[0], 3);
 }
 
+TEST(NOP_Genetic, genvar_with_counter_rng_is_reproducible) {
+    auto netOper = NetOper();
+    netOper.setPsi({
+        {1, 2, 0, 0},
+        {0, 1, 3, 0},
+        {0, 0, 1, 4},
+        {0, 0, 0, 1}
+    });
+    netOper.setNodesForVars({0});
+    netOper.setNodesForParams({1});
+    
+    // Одинаковый ключ - одинаковые вариации, вне зависимости от rand()
+    CounterRng first(42, 3, 5, RngPurpose::Mutation);
+    CounterRng second(42, 3, 5, RngPurpose::Mutation);
+    for (int i = 0; i < 20; ++i) {
+        std::vector<int> a(4), b(4);
+        std::srand(i);
+        netOper.GenVar(a, first);
+        std::srand(1000 + i);
+        netOper.GenVar(b, second);
+        EXPECT_EQ(a, b);
+        EXPECT_GE(a[0], 0);
+        EXPECT_LE(a[0], 3);
+    }
+}
+
+TEST(CounterRng, philox_known_answers) {
+    // Контрольные значения Philox4x32-10 из Random123
+    uint32_t out[4];
+    
+    const uint32_t zero_counter[4] = {0, 0, 0, 0};
+    const uint32_t zero_key[2] = {0, 0};
+    CounterRng::philox(zero_counter, zero_key, out);
+    EXPECT_EQ(out[0], 0x6627e8d5u);
+    EXPECT_EQ(out[1], 0xe169c58du);
+    EXPECT_EQ(out[2], 0xbc57ac4cu);
+    EXPECT_EQ(out[3], 0x9b00dbd8u);
+    
+    const uint32_t ones_counter[4] = {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu};
+    const uint32_t ones_key[2] = {0xffffffffu, 0xffffffffu};
+    CounterRng::philox(ones_counter, ones_key, out);
+    EXPECT_EQ(out[0], 0x408f276du);
+    EXPECT_EQ(out[1], 0x41c83b0eu);
+    EXPECT_EQ(out[2], 0xa20bc7c6u);
+    EXPECT_EQ(out[3], 0x6d5451fdu);
+    
+    const uint32_t pi_counter[4] = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+    const uint32_t pi_key[2] = {0xa4093822u, 0x299f31d0u};
+    CounterRng::philox(pi_counter, pi_key, out);
+    EXPECT_EQ(out[0], 0xd16cfe09u);
+    EXPECT_EQ(out[1], 0x94fdccebu);
+    EXPECT_EQ(out[2], 0x5001e420u);
+    EXPECT_EQ(out[3], 0x24126ea1u);
+}
+
+TEST(CounterRng, streams_are_independent_of_draw_order) {
+    CounterRng a(7, 1, 2, RngPurpose::Crossover);
+    CounterRng b(7, 1, 2, RngPurpose::Crossover);
+    CounterRng other(7, 1, 2, RngPurpose::Selection);
+    
+    // Выборки из другого потока не сдвигают этот
+    bool differs = false;
+    for (int i = 0; i < 16; ++i) {
+        const uint32_t x = a();
+        other();
+        EXPECT_EQ(x, b());
+        differs = differs || x != other();
+    }
+    EXPECT_TRUE(differs);
+    
+    CounterRng range(7, 0, 0, RngPurpose::Initialization);
+    for (int i = 0; i < 1000; ++i) {
+        const int k = range.uniformInt(5);
+        EXPECT_GE(k, 0);
+        EXPECT_LT(k, 5);
+        const float r = range.uniformReal();
+        EXPECT_GE(r, 0.0f);
+        EXPECT_LT(r, 1.0f);
+    }
+}
+
 TEST(NOP_Genetic, variations_does_not_crash) {
     auto netOper = NetOper();
     
@@ -185,6 +268,29 @@ TEST(NOP_Genetic, variations_does_not_crash) {
     EXPECT_NO_THROW(netOper.Variations(w4));
 }
 
+TEST(NOP_Genetic, noop_variations_keep_matrix) {
+    auto netOper = NetOper();
+    netOper.setPsi({
+        {1, 2, 0, 0},
+        {0, 1, 3, 0},
+        {0, 0, 1, 4},
+        {0, 0, 0, 1}
+    });
+    const auto initial = netOper.getPsi();
+    
+    netOper.Variations({0, 0, 2, 5});  // замена нулевой дуги
+    netOper.Variations({0, 0, 1, 2});  // замена на то же значение
+    netOper.Variations({2, 0, 1, 3});  // добавление поверх существующей дуги
+    netOper.Variations({3, 2, 3, 0});  // удаление единственной входящей дуги
+    netOper.Variations({0, 0, 0, 7});  // пустая вариация
+    EXPECT_EQ(netOper.getPsi(), initial);
+    
+    netOper.Variations({0, 0, 1, 5});
+    netOper.Variations({2, 0, 2, 3});
+    EXPECT_EQ(netOper.getPsi()[0][1], 5);
+    EXPECT_EQ(netOper.getPsi()[0][2], 3);
+}
+
 TEST(NOP_Genetic, variations_empty_vector) {
     auto netOper = NetOper();
     std::vector<int> w;  // Empty vector
@@ -319,3 +425,170 @@ TEST(NOP_Boundary, operations_with_negative_values) {
     EXPECT_NO_THROW(netOper.getBinaryOperationResult(1, -5.0f, -3.0f));
     EXPECT_NO_THROW(netOper.getBinaryOperationResult(2, -5.0f, -3.0f));
 }
+
+TEST(NOP_EdgeCases, calc_result_pointer_matches_vector) {
+    auto netOper = NetOper();
+    netOper.setNodesForVars({0, 1, 2});
+    netOper.setNodesForParams({3, 4, 5});
+    netOper.setNodesForOutput({22, 23});
+    netOper.setCs(qc);
+    netOper.setPsi(NopPsiN);
+    
+    std::vector<float> x_in = {1.5f, -2.0f, 0.3f};
+    std::vector<float> y_vec(2);
+    netOper.calcResult(x_in, y_vec);
+    
+    float y_ptr[2] = {0.0f, 0.0f};
+    netOper.calcResult(x_in.data(), y_ptr);
+    
+    EXPECT_FLOAT_EQ(y_ptr[0], y_vec[0]);
+    EXPECT_FLOAT_EQ(y_ptr[1], y_vec[1]);
+}
+
+// Test binary serialisation
+TEST(NOP_FileIO, binary_round_trip_matches_text) {
+    auto netOper = NetOper();
+    netOper.setNodesForVars({0, 1, 2});
+    netOper.setNodesForParams({3, 4, 5});
+    netOper.setNodesForOutput({22, 23});
+    netOper.setCs(qc);
+    netOper.setPsi(NopPsiN);
+    
+    std::string matrixFile = "/tmp/test_bin_matrix.txt";
+    std::string paramsFile = "/tmp/test_bin_params.txt";
+    std::string binFile = "/tmp/test_net.bin";
+    
+    // Текстовый формат
+    EXPECT_TRUE(netOper.saveMatrixToFile(matrixFile));
+    EXPECT_TRUE(netOper.saveParametersToFile(paramsFile));
+    auto fromText = NetOper();
+    EXPECT_TRUE(fromText.loadMatrixFromFile(matrixFile));
+    EXPECT_TRUE(fromText.loadParametersFromFile(paramsFile));
+    
+    // Бинарный формат
+    EXPECT_TRUE(netOper.saveToBinaryFile(binFile));
+    auto fromBinary = NetOper();
+    EXPECT_TRUE(fromBinary.loadFromBinaryFile(binFile));
+    
+    EXPECT_EQ(fromBinary.getPsi(), fromText.getPsi());
+    EXPECT_EQ(fromBinary.getPsi(), NopPsiN);
+    ASSERT_EQ(fromBinary.getCs().size(), fromText.getCs().size());
+    for (size_t i = 0; i < fromText.getCs().size(); ++i) {
+        // текст хранит 6 значащих цифр, бинарный формат - точно
+        EXPECT_NEAR(fromBinary.getCs()[i], fromText.getCs()[i], 0.1f);
+        EXPECT_FLOAT_EQ(fromBinary.getCs()[i], qc[i]);
+    }
+    
+    // Узлы сохраняются только в бинарном формате
+    EXPECT_EQ(fromBinary.getNodesForVars(), netOper.getNodesForVars());
+    EXPECT_EQ(fromBinary.getNodesForParams(), netOper.getNodesForParams());
+    EXPECT_EQ(fromBinary.getNodesForOutput(), netOper.getNodesForOutput());
+    
+    std::vector<float> x_in = {1.0f, -0.5f, 0.2f};
+    std::vector<float> y1(2), y2(2);
+    netOper.calcResult(x_in, y1);
+    fromBinary.calcResult(x_in, y2);
+    EXPECT_EQ(y1, y2);
+    
+    std::remove(matrixFile.c_str());
+    std::remove(paramsFile.c_str());
+    std::remove(binFile.c_str());
+}
+
+TEST(NOP_FileIO, binary_rejects_corrupted_image) {
+    auto netOper = NetOper();
+    netOper.setNodesForVars({0, 1, 2});
+    netOper.setNodesForParams({3, 4, 5});
+    netOper.setNodesForOutput({22, 23});
+    netOper.setCs(qc);
+    netOper.setPsi(NopPsiN);
+    
+    std::vector<char> image;
+    ASSERT_TRUE(netOper.toBinary(image));
+    
+    auto restored = NetOper();
+    EXPECT_TRUE(restored.fromBinary(image.data(), image.size()));
+    
+    // Порча полезной нагрузки ловится контрольной суммой
+    image[sizeof(NetOperBinaryHeader) + 3] ^= 0x5A;
+    auto corrupted = NetOper();
+    EXPECT_FALSE(corrupted.fromBinary(image.data(), image.size()));
+    
+    // Обрезанный образ
+    EXPECT_FALSE(corrupted.fromBinary(image.data(), sizeof(NetOperBinaryHeader) - 1));
+}
+
+namespace {
+
+// Малая сеть: z2 = x0 + c0, образ 65 байт
+// [40..42] диагональ, [43..54] дуги (0,2,1) и (1,2,1), [55..58] параметр, [59], [61], [63] узлы
+std::vector<char> smallNetImage() {
+    auto netOper = NetOper();
+    netOper.setNodesForVars({0});
+    netOper.setNodesForParams({1});
+    netOper.setNodesForOutput({2});
+    netOper.setCs({2.0f});
+    netOper.setPsi({{1, 0, 1}, {0, 1, 1}, {0, 0, 1}});
+    std::vector<char> image;
+    netOper.toBinary(image);
+    return image;
+}
+
+// Правка образа с пересчётом контрольной суммы: проверяется разбор, а не FNV-1a
+template <typename Edit>
+std::vector<char> resealed(Edit edit) {
+    std::vector<char> image = smallNetImage();
+    NetOperBinaryHeader header;
+    std::memcpy(&header, image.data(), sizeof(header));
+    edit(header, image);
+    uint32_t hash = 2166136261u;
+    for (size_t i = sizeof(header); i < image.size(); ++i) {
+        hash ^= static_cast<uint8_t>(image[i]);
+        hash *= 16777619u;
+    }
+    header.checksum = hash;
+    std::memcpy(image.data(), &header, sizeof(header));
+    return image;
+}
+
+void setU16(std::vector<char>& image, size_t offset, uint16_t value) {
+    std::memcpy(image.data() + offset, &value, sizeof(value));
+}
+
+bool accepts(const std::vector<char>& image) {
+    auto netOper = NetOper();
+    return netOper.fromBinary(image.data(), image.size());
+}
+
+}  // namespace
+
+TEST(NOP_FileIO, binary_rejects_invalid_contents) {
+    const auto unchanged = resealed([](NetOperBinaryHeader&, std::vector<char>&) {});
+    ASSERT_EQ(unchanged.size(), 65u);
+    ASSERT_TRUE(accepts(unchanged));
+
+    // Операции: неизвестная бинарная, узел без операции с входящей дугой, неизвестная унарная
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader&, std::vector<char>& im) { im[42] = 9; })));
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader&, std::vector<char>& im) { im[42] = 0; })));
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader&, std::vector<char>& im) { setU16(im, 47, 29); })));
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader&, std::vector<char>& im) { setU16(im, 47, 0); })));
+
+    // Узлы переменных, параметров и выходов вне матрицы
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader&, std::vector<char>& im) { setU16(im, 59, 3); })));
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader&, std::vector<char>& im) { setU16(im, 61, 100); })));
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader&, std::vector<char>& im) { setU16(im, 63, 0xFFFF); })));
+
+    // Параметров меньше, чем узлов параметров
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader& h, std::vector<char>&) { h.num_params = 0; })));
+
+    // Размеры больше образа отклоняются до выделения памяти
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader& h, std::vector<char>&) { h.num_outputs = 0xFFFFFFFFu; })));
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader& h, std::vector<char>&) { h.num_params = 0x40000000u; })));
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader& h, std::vector<char>&) { h.num_arcs = 0xFFFFFFFFu; })));
+    EXPECT_FALSE(accepts(resealed([](NetOperBinaryHeader& h, std::vector<char>&) { h.size = 0xFFFFFFFFu; })));
+}
+
+TEST(NOP_FileIO, load_nonexistent_binary_file) {
+    auto netOper = NetOper();
+    EXPECT_FALSE(netOper.loadFromBinaryFile("/nonexistent/path/net.bin"));
+}
@@ -0,0 +1,135 @@
+#include "pareto_archive.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+bool weaklyDominates(const std::vector<float>& a, const std::vector<float>& b) {
+    for (size_t j = 0; j < a.size(); ++j) {
+        if (a[j] > b[j]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Эталон: линейный архив с той же семантикой
+bool referenceInsert(std::vector<std::vector<float>>& front, const std::vector<float>& fitness) {
+    for (const auto& point : front) {
+        if (weaklyDominates(point, fitness)) {
+            return false;
+        }
+    }
+    front.erase(std::remove_if(front.begin(), front.end(),
+                               [&fitness](const std::vector<float>& point) { return weaklyDominates(fitness, point); }),
+                front.end());
+    front.push_back(fitness);
+    return true;
+}
+
+std::vector<std::vector<float>> archiveFitness(const ParetoArchive& archive) {
+    std::vector<std::vector<float>> result;
+    for (const ParetoArchiveEntry* entry : archive.entries()) {
+        result.push_back(entry->fitness);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}  // namespace
+
+TEST(ParetoArchive, MatchesLinearArchive) {
+    std::mt19937 rng(3);
+    for (size_t num_obj : {2u, 3u, 4u}) {
+        ParetoArchive archive(num_obj);
+        std::vector<std::vector<float>> front;
+        // Точки у гиперплоскости sum = 1 дают большой фронт, дискретизация - повторы и равенства
+        std::uniform_int_distribution<int> dist(0, 40);
+        
+        for (int step = 0; step < 3000; ++step) {
+            std::vector<float> fitness(num_obj);
+            float sum = 0.0f;
+            for (float& f : fitness) {
+                f = static_cast<float>(dist(rng) + 1);
+                sum += f;
+            }
+            for (float& f : fitness) {
+                f = std::round(f / sum * 20.0f) + static_cast<float>(step % 7 == 0 ? dist(rng) % 3 : 0);
+            }
+            
+            ParetoArchiveEntry entry;
+            entry.fitness = fitness;
+            entry.params = {step};
+            const bool expected = referenceInsert(front, fitness);
+            ASSERT_EQ(archive.insert(entry), expected);
+            ASSERT_EQ(archive.size(), front.size());
+        }
+        
+        std::sort(front.begin(), front.end());
+        EXPECT_EQ(archiveFitness(archive), front);
+        EXPECT_GT(front.size(), 20u);
+        
+        for (const auto& point : front) {
+            EXPECT_TRUE(archive.isDominated(point));
+        }
+    }
+}
+
+TEST(ParetoArchive, RejectsNonFiniteAndKeepsPayload) {
+    ParetoArchive archive(2);
+    ParetoArchiveEntry nan_entry;
+    nan_entry.fitness = {std::numeric_limits<float>::quiet_NaN(), 1.0f};
+    EXPECT_FALSE(archive.insert(nan_entry));
+    EXPECT_TRUE(archive.empty());
+    
+    ParetoArchiveEntry entry;
+    entry.fitness = {1.0f, 2.0f};
+    entry.params = {1, 0, 1};
+    entry.structure = {{0, 1, 2, 3}};
+    ASSERT_TRUE(archive.insert(entry));
+    
+    // Доминирующее решение вытесняет прежнее
+    ParetoArchiveEntry better;
+    better.fitness = {0.5f, 2.0f};
+    better.params = {0, 0, 0};
+    ASSERT_TRUE(archive.insert(better));
+    ASSERT_EQ(archive.size(), 1u);
+    EXPECT_EQ(archive.entries().front()->params, better.params);
+    EXPECT_FALSE(archive.isDominated(std::vector<float>{0.4f, 3.0f}));
+    EXPECT_TRUE(archive.isDominated(std::vector<float>{0.5f, 2.5f}));
+    
+    EXPECT_THROW(archive.insert(ParetoArchiveEntry{{1.0f}, {}, {}}), std::invalid_argument);
+}
+
+TEST(ParetoArchive, EntriesInInsertionOrder) {
+    auto fitnessOf = [](const std::vector<const ParetoArchiveEntry*>& entries) {
+        std::vector<std::vector<float>> result;
+        for (const ParetoArchiveEntry* entry : entries) {
+            result.push_back(entry->fitness);
+        }
+        return result;
+    };
+
+    // {0.5, 4.5} вытесняет {1, 5}, и {3, 3} занимает освободившийся номер
+    ParetoArchive archive(2);
+    ASSERT_TRUE(archive.insert(ParetoArchiveEntry{{1.0f, 5.0f}, {}, {}}));
+    ASSERT_TRUE(archive.insert(ParetoArchiveEntry{{5.0f, 1.0f}, {}, {}}));
+    ASSERT_TRUE(archive.insert(ParetoArchiveEntry{{0.5f, 4.5f}, {}, {}}));
+    ASSERT_TRUE(archive.insert(ParetoArchiveEntry{{3.0f, 3.0f}, {}, {}}));
+
+    const std::vector<std::vector<float>> expected = {{5.0f, 1.0f}, {0.5f, 4.5f}, {3.0f, 3.0f}};
+    EXPECT_EQ(fitnessOf(archive.entries()), expected);
+
+    // Архив, собранный заново из entries(), после той же вставки даёт тот же порядок
+    ParetoArchive rebuilt(2);
+    for (const ParetoArchiveEntry* entry : archive.entries()) {
+        ASSERT_TRUE(rebuilt.insert(*entry));
+    }
+    ASSERT_TRUE(archive.insert(ParetoArchiveEntry{{4.0f, 0.5f}, {}, {}}));
+    ASSERT_TRUE(rebuilt.insert(ParetoArchiveEntry{{4.0f, 0.5f}, {}, {}}));
+    EXPECT_EQ(fitnessOf(rebuilt.entries()), fitnessOf(archive.entries()));
+}
@@ -0,0 +1,80 @@
+#include "rank_selection.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+/// Исходный отбор GANOP: случайная особь и search_neighbors соперников, побеждает меньший ранг
+int tournament(const std::vector<int>& ranks, int search_neighbors, std::mt19937& rng) {
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(ranks.size()) - 1);
+    int best = dist(rng);
+    for (int i = 0; i < search_neighbors; ++i) {
+        int candidate = dist(rng);
+        if (ranks[candidate] < ranks[best]) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+std::vector<int> makeRanks() {
+    // Типичная картина: небольшой фронт и длинный хвост
+    std::vector<int> ranks;
+    for (int i = 0; i < 60; ++i) {
+        ranks.push_back(i < 5 ? 0 : (i * 7) % 23 + 1);
+    }
+    return ranks;
+}
+
+}  // namespace
+
+TEST(RankSelection, WeightsMatchTournament) {
+    const std::vector<int> ranks = makeRanks();
+    const int search_neighbors = 3;
+    const auto weights = RankSelector::tournamentWeights(ranks, search_neighbors + 1);
+    
+    double total = 0.0;
+    for (double w : weights) {
+        total += w;
+    }
+    EXPECT_NEAR(total, 1.0, 1e-12);
+    
+    std::mt19937 rng(17);
+    const int draws = 400000;
+    std::vector<int> hits(ranks.size(), 0);
+    for (int d = 0; d < draws; ++d) {
+        ++hits[tournament(ranks, search_neighbors, rng)];
+    }
+    for (size_t i = 0; i < ranks.size(); ++i) {
+        const double expected = weights[i] * draws;
+        EXPECT_NEAR(hits[i], expected, 5.0 * std::sqrt(expected) + 2.0) << "individual " << i;
+    }
+}
+
+TEST(RankSelection, AliasTableSamplesWeights) {
+    const std::vector<int> ranks = makeRanks();
+    const int tournament_size = 257;
+    const auto weights = RankSelector::tournamentWeights(ranks, tournament_size);
+    
+    RankSelector selector;
+    selector.build(ranks, tournament_size);
+    ASSERT_FALSE(selector.empty());
+    
+    CounterRng rng(5, 0, 0, RngPurpose::Selection);
+    const int draws = 400000;
+    std::vector<int> hits(ranks.size(), 0);
+    for (int d = 0; d < draws; ++d) {
+        const int idx = selector.select(rng);
+        ASSERT_GE(idx, 0);
+        ASSERT_LT(idx, static_cast<int>(ranks.size()));
+        ++hits[idx];
+    }
+    for (size_t i = 0; i < ranks.size(); ++i) {
+        const double expected = weights[i] * draws;
+        EXPECT_NEAR(hits[i], expected, 5.0 * std::sqrt(expected) + 2.0) << "individual " << i;
+    }
+    // При большом турнире почти всегда побеждает фронт
+    EXPECT_GT(hits[0] + hits[1] + hits[2] + hits[3] + hits[4], draws * 99 / 100);
+}
@@ -1,6 +1,8 @@
 #include "reader.h"
 #include <iostream>
 #include <string> 
+#include <fstream>
+#include <cstdio>
 #include <gtest/gtest.h>
 #include "nop_test_utils.h"
 
@@ -14,3 +16,74 @@ TEST(Reader, ConstructorTests)
     reader.print();
 }
 
+
+TEST(Reader, StreamingMatchesXml)
+{
+    std::string cwd = getexepath();
+    cwd = std::string(cwd.begin(), cwd.end()-9);
+    std::string matrixPath = cwd + "/test_data/24_NOP_461";
+    std::string paramsPath = cwd + "/test_data/q_461.txt";
+
+    NOPMatrixReader streaming;
+    EXPECT_TRUE(streaming.readMatrixStreaming(matrixPath));
+    EXPECT_TRUE(streaming.readParamsStreaming(paramsPath));
+
+    NOPMatrixReader xml;
+    xml.readMatrixXml(matrixPath);
+    xml.readParamsXml(paramsPath);
+
+    EXPECT_EQ(streaming.getMatrixSize(), 24);
+    EXPECT_EQ(streaming.getMatrix(), xml.getMatrix());
+    EXPECT_EQ(streaming.getParams(), xml.getParams());
+}
+
+TEST(Reader, StreamingRejectsUnknownFormat)
+{
+    std::string testFile = "/tmp/test_reader_bad.xml";
+    {
+        std::ofstream out(testFile);
+        out << "<CONFIG><grid><content><cells cellcount=\"4\">"
+            << "<cell1 column=\"1\" row=\"1\" text=\"abc\"/>"
+            << "</cells></content></grid></CONFIG>";
+    }
+
+    NOPMatrixReader reader;
+    EXPECT_FALSE(reader.readMatrixStreaming(testFile));
+    EXPECT_FALSE(reader.readMatrixStreaming("/nonexistent/path/matrix.xml"));
+
+    std::remove(testFile.c_str());
+}
+
+TEST(Reader, MalformedLegacyXmlIsRejected)
+{
+    std::string testFile = "/tmp/test_reader_malformed.xml";
+    auto write = [&](const std::string& cells_attr, const std::string& cell) {
+        std::ofstream out(testFile);
+        out << "<CONFIG><grid><content><cells " << cells_attr << ">" << cell
+            << "</cells></content></grid></CONFIG>";
+    };
+
+    NOPMatrixReader reader;
+    write("cellcount=\"9\"", "<cell1 column=\"-3\" row=\"1\" text=\"5\"/>");
+    EXPECT_FALSE(reader.readMatrixStreaming(testFile));
+    EXPECT_FALSE(reader.readParamsStreaming(testFile));
+    EXPECT_THROW(reader.readMatrix(testFile), std::invalid_argument);
+
+    write("cellcount=\"9\"", "<cell1 column=\"1\" row=\"-2\" text=\"5\"/>");
+    EXPECT_FALSE(reader.readMatrixStreaming(testFile));
+    EXPECT_FALSE(reader.readParamsStreaming(testFile));
+    EXPECT_THROW(reader.readMatrix(testFile), std::invalid_argument);
+    EXPECT_THROW(reader.readParams(testFile), std::invalid_argument);
+
+    write("cellcount=\"-16\"", "<cell1 column=\"1\" row=\"1\" text=\"5\"/>");
+    EXPECT_FALSE(reader.readMatrixStreaming(testFile));
+    EXPECT_FALSE(reader.readParamsStreaming(testFile));
+    EXPECT_THROW(reader.readMatrix(testFile), std::invalid_argument);
+    EXPECT_THROW(reader.readParams(testFile), std::invalid_argument);
+
+    write("cellcount=\"9\"", "<cell1 column=\"4\" row=\"1\" text=\"5\"/>");
+    EXPECT_FALSE(reader.readMatrixStreaming(testFile));
+    EXPECT_THROW(reader.readMatrix(testFile), std::invalid_argument);
+
+    std::remove(testFile.c_str());
+}
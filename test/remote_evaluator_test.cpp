@@ -0,0 +1,249 @@
+#include "remote_evaluator.hpp"
+#include "base_solution.hpp"
+#include "simple_config.hpp"
+#include "simple_fitness_evaluator.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+const char* TestSocketPath = "/tmp/test_nop_evaluator.sock";
+
+std::vector<std::unique_ptr<BaseSolution<SimpleConfig>>> makeSolutions(const SimpleConfig& config, int count) {
+    std::vector<std::unique_ptr<BaseSolution<SimpleConfig>>> solutions;
+    for (int i = 0; i < count; ++i) {
+        auto solution = std::make_unique<BaseSolution<SimpleConfig>>(config);
+        solution->getNetOper().setCs({0.1f * i, 2.5f - 0.05f * i});
+        solutions.push_back(std::move(solution));
+    }
+    return solutions;
+}
+
+std::vector<const ISolution*> asBatch(const std::vector<std::unique_ptr<BaseSolution<SimpleConfig>>>& solutions) {
+    std::vector<const ISolution*> batch;
+    for (const auto& solution : solutions) {
+        batch.push_back(solution.get());
+    }
+    return batch;
+}
+
+/// Worker, который подключается, берёт один пакет и либо обрывает связь, либо молчит
+void misbehavingWorker(bool hangUp) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, TestSocketPath);
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return;
+    }
+    
+    RemoteMessageHeader hello{0x57504F4Eu, RemoteHello, 0, 12};
+    char payload[12] = {};
+    int32_t num_obj = 1;
+    std::memcpy(payload, &num_obj, sizeof(num_obj));
+    send(fd, &hello, sizeof(hello), 0);
+    send(fd, payload, sizeof(payload), 0);
+    
+    RemoteMessageHeader request{};
+    recv(fd, &request, sizeof(request), MSG_WAITALL);
+    std::vector<char> networks(request.size);
+    recv(fd, networks.data(), networks.size(), MSG_WAITALL);
+    if (!hangUp) {
+        // Ждём, пока master не закроет соединение по таймауту
+        char byte;
+        while (recv(fd, &byte, 1, 0) > 0) {}
+    }
+    close(fd);
+}
+
+}  // namespace
+
+TEST(RemoteEvaluator, WorkersMatchLocalEvaluation) {
+    SimpleConfig config;
+    config.num_samples = 50;
+    auto local = std::make_shared<SimpleFitnessEvaluator>(config, 1);
+    auto solutions = makeSolutions(config, 12);
+    const auto expected = local->evaluateBatch(asBatch(solutions));
+    
+    RemoteEvaluatorConfig remote_config;
+    remote_config.endpoint = std::string("unix:") + TestSocketPath;
+    remote_config.batch_size = 2;
+    long evaluated[2] = {0, 0};
+    std::vector<std::thread> workers;
+    {
+        RemoteFitnessEvaluator master(remote_config, local);
+        for (int w = 0; w < 2; ++w) {
+            workers.emplace_back([&evaluated, &config, w]() {
+                SimpleFitnessEvaluator evaluator(config, 1);
+                evaluated[w] = runEvaluationWorker(std::string("unix:") + TestSocketPath, evaluator);
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        
+        EXPECT_EQ(master.evaluateBatch(asBatch(solutions)), expected);
+        EXPECT_EQ(master.numWorkers(), 2);
+        EXPECT_EQ(master.evaluate(*solutions[3]), expected[3]);
+        // деструктор master отправляет Shutdown
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(evaluated[0] + evaluated[1], 13);
+}
+
+TEST(RemoteEvaluator, RedispatchesAfterWorkerDeathAndTimeout) {
+    SimpleConfig config;
+    config.num_samples = 50;
+    auto local = std::make_shared<SimpleFitnessEvaluator>(config, 1);
+    auto solutions = makeSolutions(config, 10);
+    const auto expected = local->evaluateBatch(asBatch(solutions));
+    
+    RemoteEvaluatorConfig remote_config;
+    remote_config.endpoint = std::string("unix:") + TestSocketPath;
+    remote_config.batch_size = 2;
+    remote_config.timeout_ms = 300;
+    std::vector<std::thread> workers;
+    {
+        RemoteFitnessEvaluator master(remote_config, local);
+        workers.emplace_back(misbehavingWorker, true);
+        workers.emplace_back(misbehavingWorker, false);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        workers.emplace_back([&config]() {
+            SimpleFitnessEvaluator evaluator(config, 1);
+            runEvaluationWorker(std::string("unix:") + TestSocketPath, evaluator);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        
+        EXPECT_EQ(master.evaluateBatch(asBatch(solutions)), expected);
+        EXPECT_EQ(master.numWorkers(), 1);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+TEST(RemoteEvaluator, RejectsWorkerWithOtherObjectives) {
+    SimpleConfig config;
+    config.num_samples = 50;
+    auto local = std::make_shared<SimpleFitnessEvaluator>(config, 1);
+    auto solutions = makeSolutions(config, 3);
+    
+    RemoteEvaluatorConfig remote_config;
+    remote_config.endpoint = std::string("unix:") + TestSocketPath;
+    long evaluated = -1;
+    std::thread worker;
+    {
+        RemoteFitnessEvaluator master(remote_config, local);
+        worker = std::thread([&evaluated, &config]() {
+            SimpleFitnessEvaluator evaluator(config, 2);
+            evaluated = runEvaluationWorker(std::string("unix:") + TestSocketPath, evaluator);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        
+        // Без подходящих worker'ов пакет оценивается локально
+        EXPECT_EQ(master.evaluateBatch(asBatch(solutions)), local->evaluateBatch(asBatch(solutions)));
+        EXPECT_EQ(master.numWorkers(), 0);
+    }
+    worker.join();
+    EXPECT_EQ(evaluated, 0);
+}
+
+namespace {
+
+/// Evaluator worker'а, который считает одновременно идущие оценки во всех worker'ах
+class SlowEvaluator : public IFitnessEvaluator
+{
+public:
+    SlowEvaluator(const SimpleConfig& config, std::atomic<int>& in_flight, std::atomic<int>& max_in_flight)
+        : m_inner(config, 1), m_inFlight(in_flight), m_maxInFlight(max_in_flight) {}
+
+    std::vector<float> evaluate(const ISolution& solution) override {
+        return evaluateBatch({&solution}).front();
+    }
+
+    std::vector<std::vector<float>> evaluateBatch(const std::vector<const ISolution*>& solutions) override {
+        const int now = ++m_inFlight;
+        int seen = m_maxInFlight.load();
+        while (now > seen && !m_maxInFlight.compare_exchange_weak(seen, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        auto results = m_inner.evaluateBatch(solutions);
+        --m_inFlight;
+        return results;
+    }
+
+    int getNumObjectives() const override { return m_inner.getNumObjectives(); }
+    uint64_t getConfigHash() const override { return m_inner.getConfigHash(); }
+
+private:
+    SimpleFitnessEvaluator m_inner;
+    std::atomic<int>& m_inFlight;
+    std::atomic<int>& m_maxInFlight;
+};
+
+}  // namespace
+
+TEST(RemoteEvaluator, ConcurrentCallsAndSmallBatchesUseAllWorkers) {
+    SimpleConfig config;
+    config.num_samples = 50;
+    auto local = std::make_shared<SimpleFitnessEvaluator>(config, 1);
+    auto solutions = makeSolutions(config, 8);
+    const auto expected = local->evaluateBatch(asBatch(solutions));
+
+    constexpr int NumWorkers = 4;
+    RemoteEvaluatorConfig remote_config;
+    remote_config.endpoint = std::string("unix:") + TestSocketPath;
+    remote_config.batch_size = 4;
+    std::atomic<int> in_flight{0}, max_in_flight{0};
+    long evaluated[NumWorkers] = {};
+    std::vector<std::thread> workers;
+    {
+        RemoteFitnessEvaluator master(remote_config, local);
+        for (int w = 0; w < NumWorkers; ++w) {
+            workers.emplace_back([&, w]() {
+                SlowEvaluator evaluator(config, in_flight, max_in_flight);
+                evaluated[w] = runEvaluationWorker(std::string("unix:") + TestSocketPath, evaluator);
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        // Пакет из batch_size сетей делится между свободными worker'ами
+        const std::vector<const ISolution*> all = asBatch(solutions);
+        const std::vector<const ISolution*> small(all.begin(), all.begin() + 4);
+        EXPECT_EQ(master.evaluateBatch(small), std::vector<std::vector<float>>(expected.begin(), expected.begin() + 4));
+        EXPECT_EQ(max_in_flight.load(), NumWorkers);
+
+        // Одновременные evaluate() (асинхронный GANOP) идут на разных worker'ов
+        max_in_flight = 0;
+        std::vector<std::vector<float>> results(solutions.size());
+        std::vector<std::thread> callers;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < solutions.size(); ++i) {
+            callers.emplace_back([&, i]() { results[i] = master.evaluate(*solutions[i]); });
+        }
+        for (auto& caller : callers) {
+            caller.join();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(results, expected);
+        EXPECT_GE(max_in_flight.load(), 2);
+        // последовательно было бы 8 * 150 мс
+        EXPECT_LT(elapsed, std::chrono::milliseconds(8 * 150));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (long count : evaluated) {
+        EXPECT_GT(count, 0);
+    }
+}
@@ -1,6 +1,7 @@
 #include "runner.hpp"
 
 #include <gtest/gtest.h>
+#include <algorithm>
 
 TEST(Runner, FullTest)
 {
@@ -69,3 +70,282 @@ TEST(Runner, FullTest)
     EXPECT_TRUE(abs(sumdelt - sumdelt_golden) < 0.001);
 
 }
+
+namespace {
+
+// Контроллер, считающий вызовы calcControl
+class CountingController : public Controller
+{
+public:
+    using Controller::Controller;
+    Model::Control calcControl(const Model::State &currState) override
+    {
+        ++calls;
+        return Controller::calcControl(currState);
+    }
+    int calls = 0;
+};
+
+// Управление по сценарию вместо сети: Umax на оба колеса, знак меняется каждые period вызовов
+class ScriptedController : public Controller
+{
+public:
+    ScriptedController(const Model::State& goal, NetOper& netOper, int period):
+        Controller(goal, netOper), m_period(period)
+        { }
+    Model::Control calcControl(const Model::State&) override
+    {
+        const float u = (m_calls++ / m_period) % 2 == 0 ? 1.0f : -1.0f;
+        return Model::Control{u, u};
+    }
+
+private:
+    int m_period;
+    int m_calls = 0;
+};
+
+NetOper makeTestNetOper()
+{
+    NetOper netOp;
+    netOp.setNodesForVars({0, 1, 2});      // Pnum
+    netOp.setNodesForParams({3, 4, 5});    // Rnum
+    netOp.setNodesForOutput({22, 23});     // Dnum
+    netOp.setCs(qc);                       // set Cs
+    netOp.setPsi(NopPsiN);
+    return netOp;
+}
+
+}
+
+TEST(Runner, ExplicitEulerMatchesDefault)
+{
+    NetOper netOp = makeTestNetOper();
+    constexpr float dt = 0.01;
+    Model::State init = {1.0, -1.0, 0.5};
+    Model::State goal = {0.0, 0.0, 0.0};
+
+    Model model1(init, dt, "../rosbot_gazebo9_2d_model.onnx");
+    Model model2(init, dt, "../rosbot_gazebo9_2d_model.onnx");
+    Controller controller1(goal, netOp);
+    Controller controller2(goal, netOp);
+
+    Runner runner1(model1, controller1);
+    Runner runner2(model2, controller2);
+    runner2.setIntegrator(makeIntegrator(IntegrationMethod::Euler));
+    runner1.init(init);
+    runner2.init(init);
+
+    for (int i = 0; i < 50; ++i) {
+        Model::State s1 = runner1.makeStep();
+        Model::State s2 = runner2.makeStep();
+        EXPECT_TRUE(s1 == s2);
+    }
+}
+
+TEST(Runner, HeldControlCallsControllerOncePerStep)
+{
+    NetOper netOp = makeTestNetOper();
+    Model::State init = {1.0, -1.0, 0.5};
+    Model::State goal = {0.0, 0.0, 0.0};
+    Model model(init, 0.1, "../rosbot_gazebo9_2d_model.onnx");
+    CountingController controller(goal, netOp);
+    Runner runner(model, controller);
+
+    runner.setIntegrator(makeIntegrator(IntegrationMethod::RK4, true));
+    runner.init(init);
+    runner.makeStep();
+    EXPECT_EQ(controller.calls, 1);
+
+    controller.calls = 0;
+    runner.setIntegrator(makeIntegrator(IntegrationMethod::RK4, false));
+    runner.makeStep();
+    EXPECT_EQ(controller.calls, 4);
+}
+
+TEST(Runner, ArcMatchesRK4WithHeldControl)
+{
+    NetOper netOp = makeTestNetOper();
+    Model::State init = {1.0, -1.0, 0.5};
+    Model::State goal = {0.0, 0.0, 0.0};
+
+    Model model1(init, 0.1, "../rosbot_gazebo9_2d_model.onnx");
+    Model model2(init, 0.1, "../rosbot_gazebo9_2d_model.onnx");
+    Controller controller1(goal, netOp);
+    Controller controller2(goal, netOp);
+    Runner rk4(model1, controller1);
+    Runner arc(model2, controller2);
+    rk4.setIntegrator(makeIntegrator(IntegrationMethod::RK4, true));
+    arc.setIntegrator(makeIntegrator(IntegrationMethod::Arc));
+    rk4.init(init);
+    arc.init(init);
+
+    // одинаковые скорости внутри шага: RK4 почти точно повторяет дугу
+    Model::State s1 = rk4.makeStep();
+    Model::State s2 = arc.makeStep();
+    EXPECT_NEAR(s1.x, s2.x, 1e-4);
+    EXPECT_NEAR(s1.y, s2.y, 1e-4);
+    EXPECT_NEAR(s1.yaw, s2.yaw, 1e-5);
+}
+
+TEST(Runner, AdaptiveWithUnitMultipleMatchesFixed)
+{
+    NetOper netOp = makeTestNetOper();
+    constexpr float dt = 0.01;
+    Model::State init = {2.0, 1.0, -0.3};
+    Model::State goal = {0.0, 0.0, 0.0};
+
+    Model model1(init, dt, "../rosbot_gazebo9_2d_model.onnx");
+    Model model2(init, dt, "../rosbot_gazebo9_2d_model.onnx");
+    Controller controller1(goal, netOp);
+    Controller controller2(goal, netOp);
+    Runner fixed(model1, controller1);
+    Runner adaptive(model2, controller2);
+
+    AdaptiveStepping settings;
+    settings.enabled = true;
+    settings.max_step_multiple = 1;
+    adaptive.setAdaptiveStepping(settings);
+    fixed.init(init);
+    adaptive.init(init);
+
+    for (int i = 0; i < 50; ++i) {
+        Model::State s1 = fixed.makeStep();
+        Model::State s2 = adaptive.makeStep();
+        EXPECT_TRUE(s1 == s2);
+        EXPECT_FLOAT_EQ(adaptive.lastStepDt(), dt);
+    }
+}
+
+TEST(Runner, AdaptiveStepReusesStartControl)
+{
+    NetOper netOp = makeTestNetOper();
+    Model::State init = {2.0, 1.0, -0.3};
+    Model::State goal = {0.0, 0.0, 0.0};
+    Model model(init, 0.01, "../rosbot_gazebo9_2d_model.onnx");
+    CountingController controller(goal, netOp);
+    Runner runner(model, controller);
+
+    AdaptiveStepping settings;
+    settings.enabled = true;
+    settings.max_step_multiple = 1;
+    runner.setAdaptiveStepping(settings);
+    runner.init(init);
+
+    // управление в начале шага - из проверки прошлого: один вызов на шаг плюс начальный
+    for (int i = 0; i < 20; ++i) {
+        runner.makeStep();
+    }
+    EXPECT_EQ(controller.calls, 21);
+}
+
+TEST(Runner, AdaptiveStepIsBoundedMultipleOfBaseDt)
+{
+    NetOper netOp = makeTestNetOper();
+    constexpr float dt = 0.01;
+    Model::State init = {4.0, -3.0, 0.2};
+    Model::State goal = {0.0, 0.0, 0.0};
+
+    Model model(init, dt, "../rosbot_gazebo9_2d_model.onnx");
+    Controller controller(goal, netOp);
+    Runner runner(model, controller);
+    runner.setIntegrator(makeIntegrator(IntegrationMethod::Arc));
+
+    AdaptiveStepping settings;
+    settings.enabled = true;
+    settings.max_step_multiple = 8;
+    runner.setAdaptiveStepping(settings);
+    runner.init(init);
+
+    float time = 0.0f;
+    while (time < 1.5f) {
+        runner.makeStep();
+        float h = runner.lastStepDt();
+        float multiple = h / dt;
+        EXPECT_NEAR(multiple, std::round(multiple), 1e-3);
+        EXPECT_GE(multiple, 1.0f - 1e-3);
+        EXPECT_LE(multiple, 8.0f + 1e-3);
+        time += h;
+    }
+}
+
+TEST(Runner, DivergenceMonitorStopsNonFinite)
+{
+    DivergenceMonitor monitor(DivergenceGuard{});
+    const Model::State state = {1.0f, 2.0f, 0.3f};
+    EXPECT_FALSE(monitor.diverged(state, Model::Control{0.5f, -0.5f}));
+    EXPECT_TRUE(monitor.diverged(state, Model::Control{NAN, 0.0f}));
+    EXPECT_TRUE(monitor.diverged(state, Model::Control{0.0f, -INFINITY}));
+    EXPECT_TRUE(monitor.diverged(Model::State{NAN, 0.0f, 0.0f}, Model::Control{0.0f, 0.0f}));
+
+    DivergenceGuard off;
+    off.enabled = false;
+    DivergenceMonitor disabled(off);
+    EXPECT_FALSE(disabled.diverged(Model::State{NAN, 0.0f, 0.0f}, Model::Control{NAN, NAN}));
+}
+
+TEST(Runner, DivergenceMonitorCountsSaturatedSteps)
+{
+    DivergenceGuard guard;
+    guard.saturation_steps = 3;
+    DivergenceMonitor monitor(guard);
+    const Model::State state = {0.0f, 0.0f, 0.0f};
+    const Model::Control pinned = {Infinity, -Infinity};
+
+    EXPECT_FALSE(monitor.diverged(state, pinned));
+    EXPECT_FALSE(monitor.diverged(state, pinned));
+    // смена знака и ненасыщенный выход начинают счёт заново
+    EXPECT_FALSE(monitor.diverged(state, Model::Control{Infinity, Infinity}));
+    EXPECT_FALSE(monitor.diverged(state, Model::Control{Infinity, 0.5f}));
+    EXPECT_FALSE(monitor.diverged(state, pinned));
+    EXPECT_FALSE(monitor.diverged(state, pinned));
+    EXPECT_TRUE(monitor.diverged(state, pinned));
+
+    monitor.reset();
+    EXPECT_FALSE(monitor.diverged(state, pinned));
+}
+
+TEST(Runner, CutRolloutIsNoBetterThanFullFailure)
+{
+    // Значения RobotProblemConfig по умолчанию, на которые рассчитаны cut_path и cut_smoothness
+    const DivergenceGuard guard;
+    constexpr float dt = 0.033333f;
+    constexpr float timeLimit = 15.0f;
+    const Model::State init = {1.0f, -1.0f, 0.5f};
+    const Model::State goal = {0.0f, 0.0f, 0.0f};
+
+    // Крайние полные неудачи: полный газ (наибольший путь) и смена знака на каждом шаге (наибольшее ускорение)
+    for (int period : {1 << 20, 1}) {
+        NetOper netOp;
+        Model model(init, dt, "../rosbot_gazebo9_2d_model.onnx");
+        ScriptedController controller(goal, netOp, period);
+        Runner runner(model, controller);
+
+        runner.init(init);
+        RolloutCost full;
+        full.reset(init);
+        while (full.time < timeLimit)
+            full.addStep(runner.makeStep(), runner.lastStepDt());
+
+        // траектория с тем же управлением, прерванная на десятом шаге
+        runner.init(init);
+        RolloutCost cut;
+        cut.reset(init);
+        for (int i = 0; i < 10; ++i)
+            cut.addStep(runner.makeStep(), runner.lastStepDt());
+        cut.chargeCut(guard, timeLimit);
+
+        EXPECT_GE(cut.time, std::min(full.time, timeLimit)) << "period " << period;
+        EXPECT_GE(cut.path, full.path) << "period " << period;
+        EXPECT_GE(cut.smoothness, full.smoothness) << "period " << period;
+    }
+
+    // накопленное сверх штрафа не уменьшается
+    RolloutCost longer;
+    longer.time = 20.0f;
+    longer.path = 2.0f * guard.cut_path;
+    longer.smoothness = 2.0f * guard.cut_smoothness;
+    longer.chargeCut(guard, timeLimit);
+    EXPECT_EQ(longer.time, 20.0f);
+    EXPECT_EQ(longer.path, 2.0f * guard.cut_path);
+    EXPECT_EQ(longer.smoothness, 2.0f * guard.cut_smoothness);
+}
@@ -0,0 +1,95 @@
+#include "trajectory_writer.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+TEST(TrajectoryWriter, write_and_read_back) {
+    std::string testFile = "/tmp/test_trajectories.bin";
+    
+    TrajectoryWriter writer(64);  // маленький буфер, чтобы проверить сброс
+    ASSERT_TRUE(writer.open(testFile));
+    
+    writer.beginTrajectory();
+    for (int k = 0; k < 100; ++k) {
+        writer.addSample(k * 0.1f, Model::State{1.0f * k, -2.0f * k, 0.01f * k});
+    }
+    writer.endTrajectory();
+    
+    writer.beginTrajectory();
+    writer.addSample(0.0f, Model::State{5.0f, 6.0f, 7.0f});
+    writer.endTrajectory();
+    
+    EXPECT_EQ(writer.numTrajectories(), 2u);
+    EXPECT_TRUE(writer.close());
+    
+    std::vector<std::vector<float>> trajectories;
+    ASSERT_TRUE(readTrajectoryFile(testFile, trajectories));
+    ASSERT_EQ(trajectories.size(), 2u);
+    
+    // колонки подряд: Time[n], X[n], Y[n], Theta[n]
+    ASSERT_EQ(trajectories[0].size(), 400u);
+    EXPECT_FLOAT_EQ(trajectories[0][10], 1.0f);
+    EXPECT_FLOAT_EQ(trajectories[0][100 + 10], 10.0f);
+    EXPECT_FLOAT_EQ(trajectories[0][200 + 10], -20.0f);
+    EXPECT_FLOAT_EQ(trajectories[0][300 + 10], 0.1f);
+    
+    ASSERT_EQ(trajectories[1].size(), 4u);
+    EXPECT_FLOAT_EQ(trajectories[1][1], 5.0f);
+    EXPECT_FLOAT_EQ(trajectories[1][3], 7.0f);
+    
+    std::remove(testFile.c_str());
+}
+
+TEST(TrajectoryWriter, header_layout) {
+    std::string testFile = "/tmp/test_trajectories_header.bin";
+    {
+        TrajectoryWriter writer;
+        ASSERT_TRUE(writer.open(testFile));
+        writer.beginTrajectory();
+        writer.addSample(0.0f, Model::State{1.0f, 2.0f, 3.0f});
+        // close() вызывается деструктором
+    }
+    
+    std::ifstream file(testFile, std::ios::binary);
+    TrajectoryFileHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    EXPECT_EQ(std::string(header.magic), "NOPTRAJ");
+    EXPECT_EQ(header.version, TrajectoryWriter::Version);
+    EXPECT_EQ(header.num_columns, TrajectoryWriter::NumColumns);
+    EXPECT_EQ(header.num_trajectories, 1u);
+    EXPECT_EQ(header.index_offset % 8, 0u);
+    
+    std::remove(testFile.c_str());
+}
+
+TEST(TrajectoryWriter, export_to_csv) {
+    std::string binFile = "/tmp/test_trajectories_export.bin";
+    std::string csvFile = "/tmp/test_trajectories_export.csv";
+    
+    TrajectoryWriter writer;
+    ASSERT_TRUE(writer.open(binFile));
+    writer.beginTrajectory();
+    writer.addSample(0.0f, Model::State{1.0f, 2.0f, 3.0f});
+    writer.addSample(0.5f, Model::State{4.0f, 5.0f, 6.0f});
+    ASSERT_TRUE(writer.close());
+    
+    ASSERT_TRUE(exportTrajectoriesToCsv(binFile, csvFile));
+    
+    std::ifstream csv(csvFile);
+    std::string line;
+    std::getline(csv, line);
+    EXPECT_EQ(line, "Trajectory,Time,X,Y,Theta");
+    std::getline(csv, line);
+    EXPECT_EQ(line, "0,0,1,2,3");
+    std::getline(csv, line);
+    EXPECT_EQ(line, "0,0.5,4,5,6");
+    
+    std::remove(binFile.c_str());
+    std::remove(csvFile.c_str());
+}
+
+TEST(TrajectoryWriter, read_nonexistent_file) {
+    std::vector<std::vector<float>> trajectories;
+    EXPECT_FALSE(readTrajectoryFile("/nonexistent/path/trajectories.bin", trajectories));
+}
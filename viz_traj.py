@@ -1,12 +1,50 @@
+import os
 import pandas as pd
 import matplotlib.pyplot as plt
 import numpy as np
 
-# Read the CSV file
+# Заголовок trajectories.bin (см. lib/include/trajectory_writer.hpp)
+TRAJ_HEADER_DTYPE = np.dtype([
+    ("magic", "S8"),
+    ("version", "<u4"),
+    ("num_columns", "<u4"),
+    ("num_trajectories", "<u8"),
+    ("index_offset", "<u8"),
+])
+
+
+def load_trajectories_bin(path):
+    """Читает trajectories.bin через np.memmap (колонки Time, X, Y, Theta)"""
+    header = np.fromfile(path, dtype=TRAJ_HEADER_DTYPE, count=1)[0]
+    if header["magic"] != b"NOPTRAJ":
+        raise ValueError(f"{path} is not a trajectory file")
+
+    num_trajectories = int(header["num_trajectories"])
+    num_columns = int(header["num_columns"])
+    if num_trajectories == 0:
+        return pd.DataFrame(columns=["Trajectory", "Time", "X", "Y", "Theta"])
+
+    index = np.memmap(path, dtype="<u8", mode="r",
+                      offset=int(header["index_offset"]), shape=(num_trajectories, 2))
+    frames = []
+    for traj_id, (offset, length) in enumerate(index):
+        if length == 0:
+            continue
+        cols = np.memmap(path, dtype="<f4", mode="r",
+                         offset=int(offset), shape=(num_columns, int(length)))
+        frames.append(pd.DataFrame({"Trajectory": traj_id, "Time": cols[0],
+                                    "X": cols[1], "Y": cols[2], "Theta": cols[3]}))
+    return pd.concat(frames, ignore_index=True)
+
+
+# Read trajectories: binary file first, CSV as a fallback
 try:
-    data = pd.read_csv("trajectories.csv")
+    if os.path.exists("trajectories.bin"):
+        data = load_trajectories_bin("trajectories.bin")
+    else:
+        data = pd.read_csv("trajectories.csv")
 except FileNotFoundError:
-    print("Error: trajectories.csv not found. Please ensure the file exists.")
+    print("Error: trajectories.bin / trajectories.csv not found. Please ensure the file exists.")
     exit(1)
 
 # Verify columns